@@ -0,0 +1,126 @@
+#include "BaseStream.h"
+
+void BaseStream::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("write_bits", "value", "bit_count"), &BaseStream::write_bits);
+	ClassDB::bind_method(D_METHOD("read_bits", "bit_count"), &BaseStream::read_bits);
+	ClassDB::bind_method(D_METHOD("write_bool", "value"), &BaseStream::write_bool);
+	ClassDB::bind_method(D_METHOD("read_bool"), &BaseStream::read_bool);
+	ClassDB::bind_method(D_METHOD("write_varint", "value"), &BaseStream::write_varint);
+	ClassDB::bind_method(D_METHOD("read_varint"), &BaseStream::read_varint);
+	ClassDB::bind_method(D_METHOD("write_signed_varint", "value"), &BaseStream::write_signed_varint);
+	ClassDB::bind_method(D_METHOD("read_signed_varint"), &BaseStream::read_signed_varint);
+
+	ClassDB::bind_method(D_METHOD("clear"), &BaseStream::clear);
+	ClassDB::bind_method(D_METHOD("reset_read"), &BaseStream::reset_read);
+	ClassDB::bind_method(D_METHOD("is_read_overflow"), &BaseStream::is_read_overflow);
+	ClassDB::bind_method(D_METHOD("get_bit_size"), &BaseStream::get_bit_size);
+	ClassDB::bind_method(D_METHOD("get_byte_size"), &BaseStream::get_byte_size);
+
+	ClassDB::bind_method(D_METHOD("set_data", "data"), &BaseStream::set_data);
+	ClassDB::bind_method(D_METHOD("get_data"), &BaseStream::get_data);
+	ADD_PROPERTY(PropertyInfo(Variant::PACKED_BYTE_ARRAY, "data"), "set_data", "get_data");
+}
+
+void BaseStream::_reserve_bits(const uint64_t p_bit_count) {
+	const int64_t bytes = (write_position + p_bit_count + 7) >> 3;
+	if (bytes > data.size())
+		data.resize(MAX(bytes, data.size() * 2));
+}
+
+void BaseStream::write_bits(uint64_t p_value, const int p_bit_count) {
+	ERR_FAIL_COND(p_bit_count < 0 || p_bit_count > 64);
+	_reserve_bits(p_bit_count);
+	uint8_t* w = data.ptrw();
+	for (int remaining = p_bit_count; remaining > 0;) {
+		const int offset = write_position & 0b111;
+		const int count = MIN(8 - offset, remaining);
+		const uint8_t mask = ((1u << count) - 1) << offset;
+		uint8_t& byte = w[write_position >> 3];
+		byte = (byte & ~mask) | ((p_value << offset) & mask);
+		p_value >>= count;
+		remaining -= count;
+		write_position += count;
+	}
+}
+
+uint64_t BaseStream::read_bits(const int p_bit_count) {
+	ERR_FAIL_COND_V(p_bit_count < 0 || p_bit_count > 64, 0);
+	if (read_position + p_bit_count > write_position) {
+		read_overflow = true;
+		ERR_FAIL_V_MSG(0, "Reading past the end of the stream.");
+	}
+	const uint8_t* r = data.ptr();
+	uint64_t res = 0;
+	for (int shift = 0; shift < p_bit_count;) {
+		const int offset = read_position & 0b111;
+		const int count = MIN(8 - offset, p_bit_count - shift);
+		res |= (uint64_t)((r[read_position >> 3] >> offset) & ((1u << count) - 1)) << shift;
+		shift += count;
+		read_position += count;
+	}
+	return res;
+}
+
+void BaseStream::write_bool(const bool p_value) {
+	write_bits(p_value, 1);
+}
+bool BaseStream::read_bool() {
+	return read_bits(1);
+}
+
+void BaseStream::write_varint(uint64_t p_value) {
+	do {
+		const uint64_t group = p_value & 0x7F;
+		p_value >>= 7;
+		write_bits(group | (p_value ? 0x80 : 0), 8);
+	} while (p_value);
+}
+uint64_t BaseStream::read_varint() {
+	uint64_t res = 0;
+	for (int shift = 0; shift < 64; shift += 7) {
+		const uint64_t group = read_bits(8);
+		res |= (group & 0x7F) << shift;
+		if (!(group & 0x80) || read_overflow)
+			break;
+	}
+	return res;
+}
+
+void BaseStream::write_signed_varint(const int64_t p_value) {
+	write_varint(((uint64_t)p_value << 1) ^ (uint64_t)(p_value >> 63));
+}
+int64_t BaseStream::read_signed_varint() {
+	const uint64_t value = read_varint();
+	return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+void BaseStream::clear() {
+	write_position = 0;
+	read_position = 0;
+	read_overflow = false;
+}
+void BaseStream::reset_read() {
+	read_position = 0;
+	read_overflow = false;
+}
+bool BaseStream::is_read_overflow() const {
+	return read_overflow;
+}
+int BaseStream::get_bit_size() const {
+	return write_position;
+}
+int BaseStream::get_byte_size() const {
+	return (write_position + 7) >> 3;
+}
+
+void BaseStream::set_data(const PackedByteArray& p_data) {
+	data = p_data;
+	write_position = (uint64_t)p_data.size() << 3;
+	reset_read();
+}
+PackedByteArray BaseStream::get_data() const {
+	return data.slice(0, get_byte_size());
+}
+const uint8_t* BaseStream::ptr() const {
+	return data.ptr();
+}
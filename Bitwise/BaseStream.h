@@ -0,0 +1,40 @@
+#ifndef BASE_STREAM
+#define BASE_STREAM
+
+#include "core/object/ref_counted.h"
+
+class BaseStream : public RefCounted {
+	GDCLASS(BaseStream, RefCounted);
+
+private:
+	PackedByteArray data; // only grows, so a reused stream writes without allocating
+	uint64_t write_position = 0; // in bits
+	uint64_t read_position = 0;
+	bool read_overflow = false;
+
+protected:
+	static void _bind_methods();
+public:
+	void write_bits(uint64_t p_value, const int p_bit_count); // least significant bit first
+	uint64_t read_bits(const int p_bit_count);
+	void write_bool(const bool p_value);
+	bool read_bool();
+	void write_varint(uint64_t p_value); // groups of 7 bits with a continuation bit
+	uint64_t read_varint();
+	void write_signed_varint(const int64_t p_value); // zigzag encoded
+	int64_t read_signed_varint();
+
+	void clear();
+	void reset_read();
+	bool is_read_overflow() const;
+	int get_bit_size() const;
+	int get_byte_size() const;
+
+	void set_data(const PackedByteArray& p_data);
+	PackedByteArray get_data() const;
+	const uint8_t* ptr() const;
+private:
+	void _reserve_bits(const uint64_t p_bit_count);
+};
+
+#endif
@@ -0,0 +1,180 @@
+#include "BitwiseCharacter.h"
+
+void BitwiseCharacter::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_position_precision", "precision"), &BitwiseCharacter::set_position_precision);
+	ClassDB::bind_method(D_METHOD("get_position_precision"), &BitwiseCharacter::get_position_precision);
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "position_precision"), "set_position_precision", "get_position_precision");
+
+	ClassDB::bind_method(D_METHOD("set_velocity_precision", "precision"), &BitwiseCharacter::set_velocity_precision);
+	ClassDB::bind_method(D_METHOD("get_velocity_precision"), &BitwiseCharacter::get_velocity_precision);
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "velocity_precision"), "set_velocity_precision", "get_velocity_precision");
+
+	ClassDB::bind_method(D_METHOD("set_history_size", "size"), &BitwiseCharacter::set_history_size);
+	ClassDB::bind_method(D_METHOD("get_history_size"), &BitwiseCharacter::get_history_size);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "history_size", PROPERTY_HINT_RANGE, "1,256,1"), "set_history_size", "get_history_size");
+
+	ClassDB::bind_method(D_METHOD("acknowledge", "tick"), &BitwiseCharacter::acknowledge);
+	ClassDB::bind_method(D_METHOD("get_baseline_tick"), &BitwiseCharacter::get_baseline_tick);
+
+	ClassDB::bind_method(D_METHOD("write", "character", "stream", "tick"), &BitwiseCharacter::write);
+	ClassDB::bind_method(D_METHOD("read", "stream", "character", "tick"), &BitwiseCharacter::read);
+
+	BIND_ENUM_CONSTANT(FIELD_POSITION);
+	BIND_ENUM_CONSTANT(FIELD_VELOCITY);
+	BIND_ENUM_CONSTANT(FIELD_STATE);
+	BIND_ENUM_CONSTANT(FIELD_FLAGS);
+}
+
+// state in its minimal bit width, custom states are the only ones needing all 16 bits
+void BitwiseCharacter::_write_state(BaseStream* p_stream, const unsigned short p_state) {
+	int width = 0;
+	while (width < 16 && (p_state >> width))
+		++width;
+	p_stream->write_bits(width, 5);
+	p_stream->write_bits(p_state, width);
+}
+unsigned short BitwiseCharacter::_read_state(BaseStream* p_stream) {
+	const int width = p_stream->read_bits(5);
+	ERR_FAIL_COND_V(width > 16, 0);
+	return p_stream->read_bits(width);
+}
+
+const BitwiseCharacter::Quantized* BitwiseCharacter::_get_baseline(const int64_t p_tick) const {
+	if (p_tick < 0)
+		return nullptr;
+	const Quantized& quantized = history[p_tick % history.size()];
+	return quantized.tick == p_tick ? &quantized : nullptr;
+}
+
+void BitwiseCharacter::write(Character2DSideScroller* p_character, const Ref<BaseStream>& p_stream, const int64_t p_tick) {
+	ERR_FAIL_NULL(p_character);
+	ERR_FAIL_COND(p_stream.is_null());
+	ERR_FAIL_COND(p_tick < 0);
+	Character2DSideScroller::Snapshot snapshot;
+	p_character->write_snapshot(snapshot);
+
+	Quantized current;
+	current.position = Vector2i(Math::round(snapshot.position.x / position_precision), Math::round(snapshot.position.y / position_precision));
+	current.velocity = Vector2i(Math::round(snapshot.velocity.x / velocity_precision), Math::round(snapshot.velocity.y / velocity_precision));
+	current.state = snapshot.state;
+	current.facing_right = snapshot.facing_right;
+	current.on_floor = snapshot.on_floor;
+	current.tick = p_tick;
+
+	static const Quantized zero;
+	const Quantized* baseline = (baseline_tick != p_tick ? _get_baseline(baseline_tick) : nullptr);
+	const Quantized base = baseline ? *baseline : zero; // copied, current may take the slot of the baseline
+	history[p_tick % history.size()] = current;
+
+	uint8_t fields = 0;
+	if (current.position != base.position)
+		fields |= FIELD_POSITION;
+	if (current.velocity != base.velocity)
+		fields |= FIELD_VELOCITY;
+	if (current.state != base.state)
+		fields |= FIELD_STATE;
+	if (current.facing_right != base.facing_right || current.on_floor != base.on_floor)
+		fields |= FIELD_FLAGS;
+
+	BaseStream* stream = p_stream.ptr();
+	stream->write_bool(baseline);
+	if (baseline)
+		stream->write_varint(p_tick - baseline_tick);
+	stream->write_bits(fields, 4);
+	if (fields & FIELD_POSITION) {
+		stream->write_signed_varint(current.position.x - base.position.x);
+		stream->write_signed_varint(current.position.y - base.position.y);
+	}
+	if (fields & FIELD_VELOCITY) {
+		stream->write_signed_varint(current.velocity.x - base.velocity.x);
+		stream->write_signed_varint(current.velocity.y - base.velocity.y);
+	}
+	if (fields & FIELD_STATE)
+		_write_state(stream, current.state);
+	if (fields & FIELD_FLAGS)
+		stream->write_bits(current.facing_right | (current.on_floor << 1), 2);
+}
+
+bool BitwiseCharacter::read(const Ref<BaseStream>& p_stream, Character2DSideScroller* p_character, const int64_t p_tick) {
+	ERR_FAIL_NULL_V(p_character, false);
+	ERR_FAIL_COND_V(p_stream.is_null(), false);
+	ERR_FAIL_COND_V(p_tick < 0, false);
+	BaseStream* stream = p_stream.ptr();
+
+	static const Quantized zero;
+	const Quantized* baseline = nullptr;
+	if (stream->read_bool()) {
+		baseline = _get_baseline(p_tick - (int64_t)stream->read_varint());
+		ERR_FAIL_NULL_V_MSG(baseline, false, "Delta encoded against a tick that is no longer in the history.");
+	}
+	const Quantized base = baseline ? *baseline : zero;
+	Quantized current = base;
+	const uint8_t fields = stream->read_bits(4);
+	if (fields & FIELD_POSITION) {
+		current.position.x += stream->read_signed_varint();
+		current.position.y += stream->read_signed_varint();
+	}
+	if (fields & FIELD_VELOCITY) {
+		current.velocity.x += stream->read_signed_varint();
+		current.velocity.y += stream->read_signed_varint();
+	}
+	if (fields & FIELD_STATE)
+		current.state = _read_state(stream);
+	if (fields & FIELD_FLAGS) {
+		const uint8_t flags = stream->read_bits(2);
+		current.facing_right = flags & 0b01;
+		current.on_floor = flags & 0b10;
+	}
+	ERR_FAIL_COND_V(stream->is_read_overflow(), false);
+	current.tick = p_tick;
+	history[p_tick % history.size()] = current;
+
+	Character2DSideScroller::Snapshot snapshot;
+	snapshot.position = Vector2(current.position) * position_precision;
+	snapshot.velocity = Vector2(current.velocity) * velocity_precision;
+	snapshot.exact_velocity = snapshot.velocity; // not replicated, the receiver continues from the velocity
+	snapshot.exact_applied_velocity = snapshot.velocity;
+	snapshot.state = current.state;
+	snapshot.facing_right = current.facing_right;
+	snapshot.on_floor = current.on_floor;
+	snapshot.tick = p_tick;
+	p_character->read_snapshot(snapshot);
+	return true;
+}
+
+void BitwiseCharacter::acknowledge(const int64_t p_tick) {
+	ERR_FAIL_NULL_MSG(_get_baseline(p_tick), "Acknowledged tick is no longer in the history.");
+	if (p_tick > baseline_tick)
+		baseline_tick = p_tick;
+}
+int64_t BitwiseCharacter::get_baseline_tick() const {
+	return baseline_tick;
+}
+
+void BitwiseCharacter::set_position_precision(const real_t p_precision) {
+	ERR_FAIL_COND(p_precision <= 0);
+	position_precision = p_precision;
+}
+real_t BitwiseCharacter::get_position_precision() const {
+	return position_precision;
+}
+void BitwiseCharacter::set_velocity_precision(const real_t p_precision) {
+	ERR_FAIL_COND(p_precision <= 0);
+	velocity_precision = p_precision;
+}
+real_t BitwiseCharacter::get_velocity_precision() const {
+	return velocity_precision;
+}
+void BitwiseCharacter::set_history_size(const int p_size) {
+	ERR_FAIL_COND(p_size < 1);
+	history.clear();
+	history.resize(p_size);
+	baseline_tick = -1;
+}
+int BitwiseCharacter::get_history_size() const {
+	return history.size();
+}
+
+BitwiseCharacter::BitwiseCharacter() {
+	history.resize(32);
+}
@@ -0,0 +1,57 @@
+#ifndef BITWISE_CHARACTER
+#define BITWISE_CHARACTER
+
+#include "BaseStream.h"
+#include "../Character/Character2DSideScroller.h"
+
+class BitwiseCharacter : public RefCounted {
+	GDCLASS(BitwiseCharacter, RefCounted);
+
+public:
+	enum Field {
+		FIELD_POSITION = 0b0001,
+		FIELD_VELOCITY = 0b0010,
+		FIELD_STATE = 0b0100,
+		FIELD_FLAGS = 0b1000 // facing and floor contact
+	};
+
+private:
+	struct Quantized {
+		Vector2i position = Vector2i();
+		Vector2i velocity = Vector2i();
+		int64_t tick = -1;
+		unsigned short state = 0;
+		bool facing_right = true;
+		bool on_floor = false;
+	};
+	real_t position_precision = 0.0625;
+	real_t velocity_precision = 0.25;
+
+	LocalVector<Quantized> history; // what was written or read, by tick % size
+	int64_t baseline_tick = -1;
+
+protected:
+	static void _bind_methods();
+public:
+	void set_position_precision(const real_t p_precision);
+	real_t get_position_precision() const;
+	void set_velocity_precision(const real_t p_precision);
+	real_t get_velocity_precision() const;
+	void set_history_size(const int p_size);
+	int get_history_size() const;
+
+	void acknowledge(const int64_t p_tick); // the peer has this tick, later writes delta encode against it
+	int64_t get_baseline_tick() const;
+
+	void write(Character2DSideScroller* p_character, const Ref<BaseStream>& p_stream, const int64_t p_tick);
+	bool read(const Ref<BaseStream>& p_stream, Character2DSideScroller* p_character, const int64_t p_tick);
+
+	BitwiseCharacter();
+private:
+	const Quantized* _get_baseline(const int64_t p_tick) const;
+	static void _write_state(BaseStream* p_stream, const unsigned short p_state);
+	static unsigned short _read_state(BaseStream* p_stream);
+};
+
+VARIANT_ENUM_CAST(BitwiseCharacter::Field);
+#endif
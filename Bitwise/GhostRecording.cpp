@@ -0,0 +1,105 @@
+#include "GhostRecording.h"
+
+#include "../Character/Character2DSideScroller.h"
+
+enum FrameFlag {
+	FRAME_STATE_CHANGED = 0b01,
+	FRAME_FACING_RIGHT = 0b10
+};
+
+void GhostRecording::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_precision", "precision"), &GhostRecording::set_precision);
+	ClassDB::bind_method(D_METHOD("get_precision"), &GhostRecording::get_precision);
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "precision"), "set_precision", "get_precision");
+
+	ClassDB::bind_method(D_METHOD("set_tick_count", "count"), &GhostRecording::set_tick_count);
+	ClassDB::bind_method(D_METHOD("get_tick_count"), &GhostRecording::get_tick_count);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "tick_count", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_STORAGE), "set_tick_count", "get_tick_count");
+
+	ClassDB::bind_method(D_METHOD("set_data", "data"), &GhostRecording::set_data);
+	ClassDB::bind_method(D_METHOD("get_data"), &GhostRecording::get_data);
+	ADD_PROPERTY(PropertyInfo(Variant::PACKED_BYTE_ARRAY, "data", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_STORAGE), "set_data", "get_data");
+
+	ClassDB::bind_method(D_METHOD("record", "position", "state", "facing_right"), &GhostRecording::record);
+	ClassDB::bind_method(D_METHOD("record_character", "character"), &GhostRecording::record_character);
+	ClassDB::bind_method(D_METHOD("clear"), &GhostRecording::clear);
+}
+
+void GhostRecording::write_frame(BaseStream* p_stream, const Frame& p_previous, const Frame& p_frame) {
+	const bool state_changed = p_frame.state != p_previous.state;
+	p_stream->write_bits((state_changed ? FRAME_STATE_CHANGED : 0) | (p_frame.facing_right ? FRAME_FACING_RIGHT : 0), 8);
+	p_stream->write_signed_varint(p_frame.position.x - p_previous.position.x);
+	p_stream->write_signed_varint(p_frame.position.y - p_previous.position.y);
+	if (state_changed)
+		p_stream->write_varint(p_frame.state);
+}
+
+void GhostRecording::read_frame(BaseStream* p_stream, const Frame& p_previous, Frame& r_frame) {
+	const uint8_t flags = p_stream->read_bits(8);
+	r_frame.facing_right = flags & FRAME_FACING_RIGHT;
+	r_frame.position.x = p_previous.position.x + p_stream->read_signed_varint();
+	r_frame.position.y = p_previous.position.y + p_stream->read_signed_varint();
+	r_frame.state = (flags & FRAME_STATE_CHANGED ? p_stream->read_varint() : p_previous.state);
+}
+
+// a loaded recording only knows its bytes, the last tick is found by decoding it once
+void GhostRecording::_restore_last() {
+	last_valid = true;
+	last = Frame();
+	stream->reset_read();
+	for (int i = 0; i < tick_count && !stream->is_read_overflow(); ++i)
+		read_frame(stream.ptr(), last, last);
+	stream->reset_read();
+}
+
+void GhostRecording::record(const Vector2 p_position, const unsigned short p_state, const bool p_facing_right) {
+	if (!last_valid)
+		_restore_last();
+	Frame frame;
+	frame.position = Vector2i(Math::round(p_position.x / precision), Math::round(p_position.y / precision));
+	frame.state = p_state;
+	frame.facing_right = p_facing_right;
+	write_frame(stream.ptr(), last, frame);
+	last = frame;
+	++tick_count;
+}
+
+void GhostRecording::record_character(Character2DSideScroller* p_character) {
+	ERR_FAIL_NULL(p_character);
+	record(p_character->get_global_position(), p_character->get_state(), p_character->is_facing_right());
+}
+
+void GhostRecording::clear() {
+	stream->clear();
+	tick_count = 0;
+	last = Frame();
+	last_valid = true;
+}
+
+void GhostRecording::set_precision(const real_t p_precision) {
+	ERR_FAIL_COND(p_precision <= 0);
+	ERR_FAIL_COND_MSG(tick_count && p_precision != precision, "The precision of a recording can't change once ticks were recorded.");
+	precision = p_precision;
+}
+real_t GhostRecording::get_precision() const {
+	return precision;
+}
+void GhostRecording::set_data(const PackedByteArray& p_data) {
+	stream->set_data(p_data);
+	last_valid = false;
+}
+PackedByteArray GhostRecording::get_data() const {
+	return stream->get_data();
+}
+void GhostRecording::set_tick_count(const int p_count) {
+	ERR_FAIL_COND(p_count < 0);
+	tick_count = p_count;
+	last_valid = false;
+}
+int GhostRecording::get_tick_count() const {
+	return tick_count;
+}
+
+GhostRecording::GhostRecording() {
+	stream.instantiate();
+}
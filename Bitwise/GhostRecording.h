@@ -0,0 +1,51 @@
+#ifndef GHOST_RECORDING
+#define GHOST_RECORDING
+
+#include "core/io/resource.h"
+#include "BaseStream.h"
+
+class Character2DSideScroller;
+
+// Position, state and facing of a character once per physics tick, delta encoded in varints.
+// Ticks are byte aligned, so a saved recording can keep being appended to.
+class GhostRecording : public Resource {
+	GDCLASS(GhostRecording, Resource);
+
+public:
+	struct Frame {
+		Vector2i position = Vector2i(); // in units of precision
+		unsigned short state = 0;
+		bool facing_right = true;
+	};
+
+private:
+	Ref<BaseStream> stream;
+	real_t precision = 0.0625;
+	int tick_count = 0;
+	Frame last; // of the last recorded tick, what the next one is encoded against
+	bool last_valid = true; // false once data was set, until the last tick is decoded again
+
+	void _restore_last();
+
+protected:
+	static void _bind_methods();
+public:
+	void set_precision(const real_t p_precision);
+	real_t get_precision() const;
+	void set_data(const PackedByteArray& p_data);
+	PackedByteArray get_data() const;
+	void set_tick_count(const int p_count);
+	int get_tick_count() const;
+
+	void record(const Vector2 p_position, const unsigned short p_state, const bool p_facing_right);
+	void record_character(Character2DSideScroller* p_character);
+	void clear();
+
+	_FORCE_INLINE_ Vector2 to_position(const Vector2i p_position) const { return Vector2(p_position) * precision; }
+	static void write_frame(BaseStream* p_stream, const Frame& p_previous, const Frame& p_frame);
+	static void read_frame(BaseStream* p_stream, const Frame& p_previous, Frame& r_frame);
+
+	GhostRecording();
+};
+
+#endif
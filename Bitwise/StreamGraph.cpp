@@ -0,0 +1,298 @@
+#include "StreamGraph.h"
+
+#include "core/config/engine.h"
+
+uint64_t StreamGraph::topology_version = 0;
+
+void OutputPlug::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("setup", "type", "capacity"), &OutputPlug::setup);
+	ClassDB::bind_method(D_METHOD("get_type"), &OutputPlug::get_type);
+	ClassDB::bind_method(D_METHOD("get_capacity"), &OutputPlug::get_capacity);
+	ClassDB::bind_method(D_METHOD("push_value", "value"), &OutputPlug::push_value);
+	ClassDB::bind_method(D_METHOD("get_latest"), &OutputPlug::get_latest);
+
+	BIND_ENUM_CONSTANT(TYPE_BOOL);
+	BIND_ENUM_CONSTANT(TYPE_INT);
+	BIND_ENUM_CONSTANT(TYPE_FLOAT);
+	BIND_ENUM_CONSTANT(TYPE_VECTOR2);
+}
+
+void OutputPlug::setup(const Type p_type, const int p_capacity) {
+	ERR_FAIL_INDEX(p_type, TYPE_VECTOR2 + 1);
+	ERR_FAIL_COND(p_capacity < 1);
+	type = p_type;
+	samples.resize(next_power_of_2(p_capacity));
+	mask = samples.size() - 1;
+	written = 0;
+	StreamGraph::topology_changed(); // connected inputs of the old type are stale
+}
+OutputPlug::Type OutputPlug::get_type() const {
+	return type;
+}
+int OutputPlug::get_capacity() const {
+	return samples.size();
+}
+
+void OutputPlug::push(const PlugSample& p_sample) {
+	PlugSample& sample = samples[written & mask];
+	sample = p_sample;
+	sample.frame = Engine::get_singleton()->get_physics_frames();
+	++written;
+}
+
+void OutputPlug::set_processor(StreamProcessor* p_processor) {
+	processor = p_processor;
+	StreamGraph::topology_changed();
+}
+StreamProcessor* OutputPlug::get_processor() const {
+	return processor;
+}
+
+void OutputPlug::push_value(const Variant& p_value) {
+	PlugSample sample;
+	switch (type) {
+		case TYPE_BOOL:
+			sample.boolean = p_value;
+		break;
+		case TYPE_INT:
+			sample.integer = p_value;
+		break;
+		case TYPE_FLOAT:
+			sample.value = p_value;
+		break;
+		case TYPE_VECTOR2: {
+			const Vector2 vector = p_value;
+			sample.vector[0] = vector.x;
+			sample.vector[1] = vector.y;
+		} break;
+	}
+	push(sample);
+}
+Variant OutputPlug::get_latest() const {
+	if (!written)
+		return Variant();
+	return sample_to_variant(type, get_sample(written - 1));
+}
+
+Variant OutputPlug::sample_to_variant(const Type p_type, const PlugSample& p_sample) {
+	switch (p_type) {
+		case TYPE_BOOL:
+			return p_sample.boolean;
+		case TYPE_INT:
+			return p_sample.integer;
+		case TYPE_FLOAT:
+			return p_sample.value;
+		case TYPE_VECTOR2:
+			return Vector2(p_sample.vector[0], p_sample.vector[1]);
+	}
+	return Variant();
+}
+
+OutputPlug::OutputPlug() {
+	samples.resize(16);
+	mask = 15;
+}
+
+void InputPlug::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_type", "type"), &InputPlug::set_type);
+	ClassDB::bind_method(D_METHOD("get_type"), &InputPlug::get_type);
+	ClassDB::bind_method(D_METHOD("connect_plug", "source"), &InputPlug::connect_plug);
+	ClassDB::bind_method(D_METHOD("disconnect_plug"), &InputPlug::disconnect_plug);
+	ClassDB::bind_method(D_METHOD("get_source"), &InputPlug::get_source);
+	ClassDB::bind_method(D_METHOD("get_available"), &InputPlug::get_available);
+	ClassDB::bind_method(D_METHOD("pop"), &InputPlug::pop);
+	ClassDB::bind_method(D_METHOD("get_latest"), &InputPlug::get_latest);
+
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "type", PROPERTY_HINT_ENUM, "Bool,Int,Float,Vector2"), "set_type", "get_type");
+}
+
+void InputPlug::set_type(const OutputPlug::Type p_type) {
+	ERR_FAIL_INDEX(p_type, OutputPlug::TYPE_VECTOR2 + 1);
+	if (source.is_valid() && source->get_type() != p_type)
+		disconnect_plug();
+	type = p_type;
+}
+OutputPlug::Type InputPlug::get_type() const {
+	return type;
+}
+
+bool InputPlug::connect_plug(const Ref<OutputPlug>& p_source) {
+	ERR_FAIL_COND_V(p_source.is_null(), false);
+	ERR_FAIL_COND_V_MSG(p_source->get_type() != type, false, "Plugs of different types can't be connected.");
+	source = p_source;
+	read = source->get_written();
+	StreamGraph::topology_changed();
+	return true;
+}
+void InputPlug::disconnect_plug() {
+	if (source.is_null())
+		return;
+	source.unref();
+	read = 0;
+	StreamGraph::topology_changed();
+}
+Ref<OutputPlug> InputPlug::get_source() const {
+	return source;
+}
+
+bool InputPlug::read_sample(PlugSample& r_sample) {
+	if (source.is_null())
+		return false;
+	const uint64_t written = source->get_written();
+	if (read == written)
+		return false;
+	if (written - read > (uint64_t)source->get_capacity()) // the producer lapped this reader
+		read = written - source->get_capacity();
+	r_sample = source->get_sample(read++);
+	return true;
+}
+bool InputPlug::peek_latest(PlugSample& r_sample) const {
+	if (source.is_null() || !source->get_written())
+		return false;
+	r_sample = source->get_sample(source->get_written() - 1);
+	return true;
+}
+int InputPlug::get_available() const {
+	if (source.is_null())
+		return 0;
+	return MIN(source->get_written() - read, (uint64_t)source->get_capacity());
+}
+
+void InputPlug::set_processor(StreamProcessor* p_processor) {
+	processor = p_processor;
+	StreamGraph::topology_changed();
+}
+StreamProcessor* InputPlug::get_processor() const {
+	return processor;
+}
+
+Variant InputPlug::pop() {
+	PlugSample sample;
+	if (!read_sample(sample))
+		return Variant();
+	return OutputPlug::sample_to_variant(type, sample);
+}
+Variant InputPlug::get_latest() const {
+	PlugSample sample;
+	if (!peek_latest(sample))
+		return Variant();
+	return OutputPlug::sample_to_variant(type, sample);
+}
+
+StreamProcessor::~StreamProcessor() {
+	while (!stream_graphs.is_empty())
+		stream_graphs[0]->remove_processor(this);
+}
+
+void StreamGraph::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("toggle_evaluate_on_physics", "physics"), &StreamGraph::toggle_evaluate_on_physics);
+	ClassDB::bind_method(D_METHOD("is_evaluate_on_physics"), &StreamGraph::is_evaluate_on_physics);
+	ClassDB::bind_method(D_METHOD("evaluate", "delta"), &StreamGraph::evaluate);
+
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "evaluate_on_physics"), "toggle_evaluate_on_physics", "is_evaluate_on_physics");
+}
+
+void StreamGraph::_notification(int p_notification) {
+	switch (p_notification) {
+		case NOTIFICATION_READY:
+			_update_processing();
+		break;
+		case NOTIFICATION_INTERNAL_PHYSICS_PROCESS:
+			evaluate(get_physics_process_delta_time());
+		break;
+		case NOTIFICATION_INTERNAL_PROCESS:
+			evaluate(get_process_delta_time());
+		break;
+	};
+}
+
+void StreamGraph::_update_processing() {
+	if (Engine::get_singleton()->is_editor_hint())
+		return;
+	set_physics_process_internal(evaluate_on_physics);
+	set_process_internal(!evaluate_on_physics);
+}
+
+void StreamGraph::topology_changed() {
+	++topology_version;
+}
+
+// Kahn's algorithm, a processor depends on the processors owning the outputs its inputs read.
+void StreamGraph::_sort() {
+	sorted_version = topology_version;
+	order.clear();
+	in_degree.resize(processors.size());
+	for (uint32_t i = 0; i < processors.size(); ++i) {
+		in_degree[i] = 0;
+		for (uint32_t j = 0; j < processors[i]->_get_stream_input_count(); ++j) {
+			const InputPlug* input = processors[i]->_get_stream_input(j);
+			const OutputPlug* source = (input ? input->get_source_ptr() : nullptr);
+			if (source && source->get_processor() && source->get_processor() != processors[i] && processors.find(source->get_processor()) >= 0)
+				++in_degree[i];
+		}
+		if (!in_degree[i])
+			order.push_back(processors[i]);
+	}
+	for (uint32_t head = 0; head < order.size(); ++head) {
+		const StreamProcessor* done = order[head];
+		for (uint32_t i = 0; i < processors.size(); ++i) {
+			if (!in_degree[i])
+				continue;
+			for (uint32_t j = 0; j < processors[i]->_get_stream_input_count(); ++j) {
+				const InputPlug* input = processors[i]->_get_stream_input(j);
+				const OutputPlug* source = (input ? input->get_source_ptr() : nullptr);
+				if (source && source->get_processor() == done && !--in_degree[i]) {
+					order.push_back(processors[i]);
+					break;
+				}
+			}
+		}
+	}
+	if (order.size() == processors.size())
+		return;
+	ERR_PRINT("StreamGraph has a cycle, the processors in it are evaluated in the order they were added.");
+	for (uint32_t i = 0; i < processors.size(); ++i) {
+		if (in_degree[i])
+			order.push_back(processors[i]);
+	}
+}
+
+void StreamGraph::add_processor(StreamProcessor* p_processor) {
+	ERR_FAIL_NULL(p_processor);
+	ERR_FAIL_COND(processors.find(p_processor) >= 0);
+	processors.push_back(p_processor);
+	p_processor->stream_graphs.push_back(this);
+	sorted_version = UINT64_MAX;
+}
+void StreamGraph::remove_processor(StreamProcessor* p_processor) {
+	if (!processors.erase(p_processor))
+		return;
+	p_processor->stream_graphs.erase(this);
+	order.erase(p_processor);
+	sorted_version = UINT64_MAX;
+}
+
+void StreamGraph::toggle_evaluate_on_physics(const bool p_physics) {
+	evaluate_on_physics = p_physics;
+	if (is_inside_tree())
+		_update_processing();
+}
+bool StreamGraph::is_evaluate_on_physics() const {
+	return evaluate_on_physics;
+}
+
+void StreamGraph::evaluate(const double delta) {
+	if (sorted_version != topology_version)
+		_sort();
+	for (uint32_t i = 0; i < order.size(); ++i)
+		order[i]->_evaluate_stream(delta);
+}
+
+StreamGraph::StreamGraph() {
+	set_physics_process_priority(-1); // before the nodes consuming what the processors produced
+}
+
+StreamGraph::~StreamGraph() {
+	for (uint32_t i = 0; i < processors.size(); ++i)
+		processors[i]->stream_graphs.erase(this);
+}
@@ -0,0 +1,140 @@
+#ifndef STREAM_GRAPH
+#define STREAM_GRAPH
+
+#include "core/object/ref_counted.h"
+#include "core/templates/local_vector.h"
+#include "scene/main/node.h"
+
+class StreamProcessor;
+class StreamGraph;
+
+struct PlugSample {
+	union {
+		bool boolean;
+		int32_t integer;
+		real_t value;
+		real_t vector[2];
+	};
+	uint64_t frame = 0; // physics frame it was pushed on
+
+	PlugSample() { vector[0] = vector[1] = 0; }
+};
+
+// Fixed capacity ring buffer written by a producer, connected InputPlugs read it in place.
+class OutputPlug : public RefCounted {
+	GDCLASS(OutputPlug, RefCounted);
+
+public:
+	enum Type {
+		TYPE_BOOL,
+		TYPE_INT,
+		TYPE_FLOAT,
+		TYPE_VECTOR2
+	};
+
+private:
+	Type type = TYPE_FLOAT;
+	LocalVector<PlugSample> samples;
+	uint32_t mask = 0; // capacity - 1, the capacity is a power of two
+	uint64_t written = 0; // samples ever pushed, the next one goes to written & mask
+	StreamProcessor* processor = nullptr; // evaluated before any processor reading this plug
+
+protected:
+	static void _bind_methods();
+public:
+	void setup(const Type p_type, const int p_capacity);
+	Type get_type() const;
+	int get_capacity() const;
+
+	void push(const PlugSample& p_sample);
+	_FORCE_INLINE_ uint64_t get_written() const { return written; }
+	_FORCE_INLINE_ const PlugSample& get_sample(const uint64_t p_sequence) const { return samples[p_sequence & mask]; }
+
+	void set_processor(StreamProcessor* p_processor);
+	StreamProcessor* get_processor() const;
+
+	void push_value(const Variant& p_value);
+	Variant get_latest() const;
+
+	static Variant sample_to_variant(const Type p_type, const PlugSample& p_sample);
+
+	OutputPlug();
+};
+
+class InputPlug : public RefCounted {
+	GDCLASS(InputPlug, RefCounted);
+
+	OutputPlug::Type type = OutputPlug::TYPE_FLOAT;
+	Ref<OutputPlug> source;
+	uint64_t read = 0; // sequence of the next sample to read
+	StreamProcessor* processor = nullptr;
+
+protected:
+	static void _bind_methods();
+public:
+	void set_type(const OutputPlug::Type p_type);
+	OutputPlug::Type get_type() const;
+
+	bool connect_plug(const Ref<OutputPlug>& p_source); // only samples pushed after connecting are read
+	void disconnect_plug();
+	Ref<OutputPlug> get_source() const;
+	_FORCE_INLINE_ OutputPlug* get_source_ptr() const { return *source; }
+
+	bool read_sample(PlugSample& r_sample); // false once every sample was read, skips samples the ring overwrote
+	bool peek_latest(PlugSample& r_sample) const;
+	int get_available() const;
+
+	void set_processor(StreamProcessor* p_processor);
+	StreamProcessor* get_processor() const;
+
+	Variant pop();
+	Variant get_latest() const;
+};
+
+// Native processors evaluated by a StreamGraph, after every processor producing their inputs.
+// A processor leaves its graphs when it is freed, plugs pointing at it are cleared by the implementation.
+class StreamProcessor {
+	friend class StreamGraph;
+	LocalVector<StreamGraph*> stream_graphs;
+public:
+	virtual void _evaluate_stream(const double delta) = 0;
+	virtual uint32_t _get_stream_input_count() const { return 0; }
+	virtual InputPlug* _get_stream_input(const uint32_t p_index) const { return nullptr; }
+	virtual ~StreamProcessor();
+};
+
+class StreamGraph : public Node {
+	GDCLASS(StreamGraph, Node);
+
+	static uint64_t topology_version; // bumped on any connection change, graphs sort again lazily
+
+	LocalVector<StreamProcessor*> processors;
+	LocalVector<StreamProcessor*> order;
+	LocalVector<uint32_t> in_degree; // scratch of the sort, kept to not allocate
+	uint64_t sorted_version = UINT64_MAX;
+	bool evaluate_on_physics = true;
+
+	void _sort();
+	void _update_processing();
+
+protected:
+	void _notification(int p_notification);
+	static void _bind_methods();
+public:
+	static void topology_changed();
+
+	void add_processor(StreamProcessor* p_processor);
+	void remove_processor(StreamProcessor* p_processor);
+
+	void toggle_evaluate_on_physics(const bool p_physics);
+	bool is_evaluate_on_physics() const;
+
+	void evaluate(const double delta);
+
+	StreamGraph();
+	~StreamGraph();
+};
+
+VARIANT_ENUM_CAST(OutputPlug::Type);
+
+#endif
@@ -1,9 +1,55 @@
 #include "Character2DSideScroller.h"
 
+#include "core/config/engine.h"
+#include "core/version.h"
+#include "core/object/worker_thread_pool.h"
+#include "scene/2d/camera_2d.h"
+#include "scene/main/viewport.h"
+#include "scene/resources/shape_2d.h"
+#include "scene/resources/world_2d.h"
+#include "servers/physics_server_2d.h"
+#include "../Profiling/AllocationCounter.h"
+#include "../Profiling/Tracer.h"
+#ifdef MARTHVON_MONITORS
+#include "core/os/os.h"
+#include "main/performance.h"
+#endif
+
+LocalVector<Character2DSideScroller*> Character2DSideScroller::parallel_characters;
+uint64_t Character2DSideScroller::parallel_frame = 0;
+
+LocalVector<ObjectID> Character2DSideScroller::lod_observers;
+LocalVector<Vector2> Character2DSideScroller::lod_observer_positions;
+uint64_t Character2DSideScroller::lod_observer_frame = 0;
+uint32_t Character2DSideScroller::lod_phase_counter = 0;
+real_t Character2DSideScroller::lod_near_distance = 1024;
+real_t Character2DSideScroller::lod_far_distance = 2048;
+uint8_t Character2DSideScroller::lod_mid_interval = 2;
+uint8_t Character2DSideScroller::lod_far_interval = 4;
+
+static const real_t kinematic_floor_probe = 0.01; // a kinematic box resting on a cell has to be within this of it
+
+#ifdef MARTHVON_MONITORS
+uint64_t Character2DSideScroller::monitor_frame_values[MONITOR_MAX] = {};
+uint64_t Character2DSideScroller::monitor_last_frame_values[MONITOR_MAX] = {};
+uint64_t Character2DSideScroller::monitor_frame = 0;
+bool Character2DSideScroller::monitors_registered = false;
+#endif
+
 void Character2DSideScroller::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_state", "state"), &Character2DSideScroller::set_state);
 	ClassDB::bind_method(D_METHOD("get_state"), &Character2DSideScroller::get_state);
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "state", PROPERTY_HINT_FLAGS), "set_state", "get_state");
+	ClassDB::bind_method(D_METHOD("add_state_listener", "callable", "mask"), &Character2DSideScroller::add_state_listener, DEFVAL(STATE_MASK_ALL));
+	ClassDB::bind_method(D_METHOD("remove_state_listener", "callable"), &Character2DSideScroller::remove_state_listener);
+	ADD_SIGNAL(MethodInfo("state_changed", PropertyInfo(Variant::INT, "old_state"), PropertyInfo(Variant::INT, "new_state")));
+
+	BIND_ENUM_CONSTANT(STATE_MASK_IDLE);
+	BIND_ENUM_CONSTANT(STATE_MASK_GROUNDED);
+	BIND_ENUM_CONSTANT(STATE_MASK_AIR);
+	BIND_ENUM_CONSTANT(STATE_MASK_REVERSE_TRANSITION);
+	BIND_ENUM_CONSTANT(STATE_MASK_CUSTOM);
+	BIND_ENUM_CONSTANT(STATE_MASK_ALL);
 
 	ClassDB::bind_method(D_METHOD("set_grounded_movement_data", "grounded_movement"), &Character2DSideScroller::set_grounded_movement_data);
 	ClassDB::bind_method(D_METHOD("get_grounded_movement_data"), &Character2DSideScroller::get_grounded_movement_data);
@@ -12,6 +58,10 @@ void Character2DSideScroller::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_jumping_movement_data", "jumping_movement"), &Character2DSideScroller::set_jumping_movement_data);
 	ClassDB::bind_method(D_METHOD("get_jumping_movement_data"), &Character2DSideScroller::get_jumping_movement_data);
 	ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "jumping_movement", PROPERTY_HINT_RESOURCE_TYPE, "MovementData2D"), "set_jumping_movement_data", "get_jumping_movement_data");
+
+	ClassDB::bind_method(D_METHOD("set_movement_set", "movement_set"), &Character2DSideScroller::set_movement_set);
+	ClassDB::bind_method(D_METHOD("get_movement_set"), &Character2DSideScroller::get_movement_set);
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "movement_set", PROPERTY_HINT_RESOURCE_TYPE, "MovementSet"), "set_movement_set", "get_movement_set");
 	
 	ClassDB::bind_method(D_METHOD("toggle_movement_disable", "disable_movement"), &Character2DSideScroller::toggle_movement_disable);
 	ClassDB::bind_method(D_METHOD("is_movement_disable"), &Character2DSideScroller::is_movement_disable);
@@ -33,9 +83,173 @@ void Character2DSideScroller::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("toggle_facing_right", "facing_right"), &Character2DSideScroller::toggle_facing_right);
 	ClassDB::bind_method(D_METHOD("is_facing_right"), &Character2DSideScroller::is_facing_right);
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "facing_right"), "toggle_facing_right", "is_facing_right");
+
+	ClassDB::bind_method(D_METHOD("toggle_parallel_process", "parallel"), &Character2DSideScroller::toggle_parallel_process);
+	ClassDB::bind_method(D_METHOD("is_parallel_process"), &Character2DSideScroller::is_parallel_process);
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "parallel_process"), "toggle_parallel_process", "is_parallel_process");
+
+	ClassDB::bind_method(D_METHOD("toggle_movement_lod", "lod"), &Character2DSideScroller::toggle_movement_lod);
+	ClassDB::bind_method(D_METHOD("is_movement_lod"), &Character2DSideScroller::is_movement_lod);
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "movement_lod"), "toggle_movement_lod", "is_movement_lod");
+	ClassDB::bind_method(D_METHOD("wake_up"), &Character2DSideScroller::wake_up);
+	ClassDB::bind_method(D_METHOD("is_sleeping"), &Character2DSideScroller::is_sleeping);
+
+	ClassDB::bind_method(D_METHOD("toggle_interpolate_visual", "interpolate"), &Character2DSideScroller::toggle_interpolate_visual);
+	ClassDB::bind_method(D_METHOD("is_interpolate_visual"), &Character2DSideScroller::is_interpolate_visual);
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "interpolate_visual"), "toggle_interpolate_visual", "is_interpolate_visual");
+	ClassDB::bind_method(D_METHOD("teleport", "position"), &Character2DSideScroller::teleport);
+	ClassDB::bind_method(D_METHOD("reset_character", "position", "facing_right"), &Character2DSideScroller::reset_character);
+	ClassDB::bind_method(D_METHOD("reset_interpolation"), &Character2DSideScroller::reset_interpolation);
+
+	ClassDB::bind_method(D_METHOD("toggle_exact_integration", "exact"), &Character2DSideScroller::toggle_exact_integration);
+	ClassDB::bind_method(D_METHOD("is_exact_integration"), &Character2DSideScroller::is_exact_integration);
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "exact_integration"), "toggle_exact_integration", "is_exact_integration");
+
+	ClassDB::bind_method(D_METHOD("set_ghost_recording", "recording"), &Character2DSideScroller::set_ghost_recording);
+	ClassDB::bind_method(D_METHOD("get_ghost_recording"), &Character2DSideScroller::get_ghost_recording);
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "ghost_recording", PROPERTY_HINT_RESOURCE_TYPE, "GhostRecording"), "set_ghost_recording", "get_ghost_recording");
+
+	ClassDB::bind_method(D_METHOD("set_kinematic_grid", "grid"), &Character2DSideScroller::set_kinematic_grid);
+	ClassDB::bind_method(D_METHOD("get_kinematic_grid"), &Character2DSideScroller::get_kinematic_grid);
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "kinematic_grid", PROPERTY_HINT_RESOURCE_TYPE, "TileOccupancyGrid2D"), "set_kinematic_grid", "get_kinematic_grid");
+	ClassDB::bind_method(D_METHOD("update_kinematic_box"), &Character2DSideScroller::update_kinematic_box);
+	ClassDB::bind_method(D_METHOD("update_shape_size"), &Character2DSideScroller::update_shape_size);
+	ClassDB::bind_method(D_METHOD("move_character"), &Character2DSideScroller::move_character);
+	ClassDB::bind_method(D_METHOD("is_character_on_floor"), &Character2DSideScroller::is_character_on_floor);
+	ClassDB::bind_method(D_METHOD("is_character_on_wall"), &Character2DSideScroller::is_character_on_wall);
+	ClassDB::bind_method(D_METHOD("is_character_on_ceiling"), &Character2DSideScroller::is_character_on_ceiling);
+
+	ClassDB::bind_method(D_METHOD("set_substep_fraction", "fraction"), &Character2DSideScroller::set_substep_fraction);
+	ClassDB::bind_method(D_METHOD("get_substep_fraction"), &Character2DSideScroller::get_substep_fraction);
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "substep_fraction", PROPERTY_HINT_RANGE, "0,2,0.01"), "set_substep_fraction", "get_substep_fraction");
+	ClassDB::bind_method(D_METHOD("set_max_substeps", "substeps"), &Character2DSideScroller::set_max_substeps);
+	ClassDB::bind_method(D_METHOD("get_max_substeps"), &Character2DSideScroller::get_max_substeps);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_substeps", PROPERTY_HINT_RANGE, "1,32,1"), "set_max_substeps", "get_max_substeps");
+	ClassDB::bind_method(D_METHOD("get_substep_count"), &Character2DSideScroller::get_substep_count);
+	ClassDB::bind_method(D_METHOD("toggle_auto_move", "auto_move"), &Character2DSideScroller::toggle_auto_move);
+	ClassDB::bind_method(D_METHOD("is_auto_move"), &Character2DSideScroller::is_auto_move);
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "auto_move"), "toggle_auto_move", "is_auto_move");
+
+	ClassDB::bind_method(D_METHOD("set_rollback_capacity", "capacity"), &Character2DSideScroller::set_rollback_capacity);
+	ClassDB::bind_method(D_METHOD("get_rollback_capacity"), &Character2DSideScroller::get_rollback_capacity);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "rollback_capacity", PROPERTY_HINT_RANGE, "0,256,1"), "set_rollback_capacity", "get_rollback_capacity");
+	ClassDB::bind_method(D_METHOD("save_state", "tick"), &Character2DSideScroller::save_state);
+	ClassDB::bind_method(D_METHOD("restore_state", "tick"), &Character2DSideScroller::restore_state);
+	ClassDB::bind_method(D_METHOD("resimulate", "from_tick", "inputs"), &Character2DSideScroller::resimulate);
+
+#ifdef MARTHVON_MONITORS
+	ClassDB::bind_method(D_METHOD("get_monitors"), &Character2DSideScroller::get_monitors);
+	ClassDB::bind_method(D_METHOD("reset_monitors"), &Character2DSideScroller::reset_monitors);
+#endif
+
+	ClassDB::bind_static_method("Character2DSideScroller", D_METHOD("add_lod_observer", "observer"), &Character2DSideScroller::add_lod_observer);
+	ClassDB::bind_static_method("Character2DSideScroller", D_METHOD("remove_lod_observer", "observer"), &Character2DSideScroller::remove_lod_observer);
+	ClassDB::bind_static_method("Character2DSideScroller", D_METHOD("set_lod_distances", "near", "far"), &Character2DSideScroller::set_lod_distances);
+	ClassDB::bind_static_method("Character2DSideScroller", D_METHOD("set_lod_intervals", "mid_interval", "far_interval"), &Character2DSideScroller::set_lod_intervals);
+}
+
+void Character2DSideScroller::_character_process(const double delta) {
+	TRACE_SCOPE("Character2DSideScroller::_character_process");
+	ProcessSource source;
+	_get_process_source(source);
+	ProcessResult res;
+	if (_process_movement(source, delta, res))
+		_apply_movement(res, delta);
+	else
+		_process_transition(delta);
+}
+
+void Character2DSideScroller::_get_process_source(ProcessSource& r_source) const {
+	r_source.velocity = get_velocity();
+	r_source.previous_velocity = _get_previous_velocity();
+	r_source.position = get_global_position();
+	r_source.movement_version = movement_version;
+	r_source.state = state;
+	r_source.on_floor = _is_on_floor();
+}
+
+// Settled states only read the source and the movement data, so this is safe to run off the physics thread.
+bool Character2DSideScroller::_process_movement(const ProcessSource& p_source, const double delta, ProcessResult& r_result) const {
+	const unsigned short state = p_source.state;
+	const uint8_t grounded_state = (state >> 1) & 0b1111;
+	uint8_t air_state = ((state >> 5) & 0b1111);
+	if (((grounded_state || (state & 0b1)) && air_state) || !(state >> 10))
+		return false;
+	const bool on_floor = p_source.on_floor;
+	r_result.velocity = p_source.velocity;
+	r_result.exact_velocity = p_source.previous_velocity;
+	r_result.state = state;
+	r_result.transition = false;
+	if (grounded_state) {
+		r_result.velocity = _integrate(*states_grounded_movement_data[grounded_state], (exact_integration ? r_result.exact_velocity : r_result.velocity), delta, false, r_result.exact_velocity);
+		if (!on_floor) {
+			r_result.state = (unsigned short)(State::STATE_FALLING);
+			air_state = 1;
+		}
+	}
+	if (air_state) {
+		r_result.velocity = _integrate(*states_jumping_movement_data[air_state], (exact_integration ? r_result.exact_velocity : r_result.velocity), delta, false, r_result.exact_velocity);
+		if (on_floor) {
+			r_result.state = air_state | (unsigned short)(State::STATE_IDLE) | (unsigned short)(State::REVERSE_TRANSITION_BIT_FLAG);
+			r_result.transition = true;
+		}
+	}
+	return true;
+}
+
+void Character2DSideScroller::_apply_movement(const ProcessResult& p_result, const double delta) {
+	set_velocity(p_result.velocity);
+	exact_velocity = p_result.exact_velocity;
+	exact_applied_velocity = p_result.velocity;
+	set_state(p_result.state);
+	if (p_result.transition)
+		_character_process(delta); // transition
+}
+
+// a collision or a script changed the velocity since the last tick, continue from it instead
+Vector2 Character2DSideScroller::_get_previous_velocity() const {
+	return (exact_integration && get_velocity() == exact_applied_velocity) ? exact_velocity : get_velocity();
+}
+
+Vector2 Character2DSideScroller::_integrate(const GroundedMovementData1D* p_data, const Vector2 p_previous, const double delta, const bool transitioning, Vector2& r_exact_velocity) const {
+	if (!exact_integration)
+		return p_data->get_velocity(p_previous, delta, transitioning);
+	return p_data->get_exact_velocity(p_previous, delta, transitioning, r_exact_velocity);
 }
 
-void Character2DSideScroller::_character_process(const double delta) { //refactor
+void Character2DSideScroller::_transition_velocity(const GroundedMovementData1D* p_data, const double delta) {
+	ProcessResult res;
+	res.velocity = _integrate(p_data, _get_previous_velocity(), delta, true, res.exact_velocity);
+	set_velocity(res.velocity);
+	exact_velocity = res.exact_velocity;
+	exact_applied_velocity = res.velocity;
+}
+
+// Script callbacks are looked up every tick, their names are built once instead of on every call.
+// Only the main thread runs transitions, so the tables fill lazily without locking.
+static const StringName& _transition_method(const uint8_t p_from, const uint8_t p_to) {
+	static StringName names[64][64];
+	StringName& name = names[p_from][p_to];
+	if (name == StringName())
+		name = "_transition_" + itos(p_from) + "to" + itos(p_to);
+	return name;
+}
+static const StringName& _transition_to_idle_method(const uint8_t p_from) {
+	static StringName names[16];
+	StringName& name = names[p_from];
+	if (name == StringName())
+		name = "transition_to_idle_from_" + itos(p_from);
+	return name;
+}
+static const StringName& _state_method(const uint8_t p_state) {
+	static StringName names[64];
+	StringName& name = names[p_state];
+	if (name == StringName())
+		name = "_state_" + itos(p_state);
+	return name;
+}
+
+void Character2DSideScroller::_process_transition(const double delta) {
 	const uint8_t grounded_state = (state >> 1) & 0b1111;
 	uint8_t air_state = ((state >> 5) & 0b1111);
 	const uint8_t custom_state = (state >> 10);
@@ -43,20 +257,20 @@ void Character2DSideScroller::_character_process(const double delta) { //refacto
 	if ((grounded_state || (state & 0b1)) && air_state) {
 		if (reverse_transition) {
 			if (state & 0b1) {
-				if (_call_script_instance(String("transition_to_idle_from_") + (grounded_state ? grounded_state : air_state), delta)) {
+				if (_call_script_instance(_transition_to_idle_method(grounded_state ? grounded_state : air_state), delta)) {
 					set_velocity(Vector2());
 					set_state((unsigned short)State::STATE_IDLE);
 				}
 				return;
 			}
-			if (_call_script_instance(String("_transition_") + air_state + "to" + grounded_state, delta)) {
-				set_velocity(states_grounded_movement_data.get(grounded_state)->get_velocity(get_velocity(), delta, true));
+			if (_call_script_instance(_transition_method(air_state, grounded_state), delta)) {
+				_transition_velocity(*states_grounded_movement_data.get(grounded_state), delta);
 				set_state(grounded_state);
 			}
 			return;
 		}
-		if (_call_script_instance(String("_transition_") + grounded_state + "to" + air_state, delta)) {
-			set_velocity(states_jumping_movement_data.get(air_state)->get_velocity(get_velocity(), delta, true));
+		if (_call_script_instance(_transition_method(grounded_state, air_state), delta)) {
+			_transition_velocity(*states_jumping_movement_data.get(air_state), delta);
 			set_state(air_state);
 		}
 		return;
@@ -64,79 +278,316 @@ void Character2DSideScroller::_character_process(const double delta) { //refacto
 	if (!custom_state) {
 		if (air_state) {
 			if (reverse_transition) {
-				if (_call_script_instance(String("_transition_") + custom_state + "to" + air_state, delta)) {
-					set_velocity(states_jumping_movement_data.get(air_state)->get_velocity(get_velocity(), delta, true));
+				if (_call_script_instance(_transition_method(custom_state, air_state), delta)) {
+					_transition_velocity(*states_jumping_movement_data.get(air_state), delta);
 					set_state(air_state);
 				}
 				return;
 			}
-			if(_call_script_instance(String("_transition_") + air_state + "to" + custom_state, delta))
+			if(_call_script_instance(_transition_method(air_state, custom_state), delta))
 				set_state(custom_state);
 			return;
 		}
 		if (grounded_state) {
 			if (reverse_transition) {
-				if (_call_script_instance(String("_transition_") + custom_state + "to" + grounded_state, delta)) {
-					set_velocity(states_grounded_movement_data.get(grounded_state)->get_velocity(get_velocity(), delta, true));
+				if (_call_script_instance(_transition_method(custom_state, grounded_state), delta)) {
+					_transition_velocity(*states_grounded_movement_data.get(grounded_state), delta);
 					set_state(grounded_state);
 				}
 			}
-			if(_call_script_instance(String("_transition_") + grounded_state + "to" + custom_state, delta))
+			if(_call_script_instance(_transition_method(grounded_state, custom_state), delta))
 				set_state(custom_state);
 			return;
 		}
-		_call_script_instance(String("_state_") + custom_state, delta);
-		return;
+		_call_script_instance(_state_method(custom_state), delta);
 	}
-	if (grounded_state) {
-		set_velocity(states_grounded_movement_data.get(grounded_state)->get_velocity(get_velocity(), delta));
-		if (!is_on_floor()) {
-			set_state((unsigned short)(State::STATE_FALLING));
-			air_state = 1;
+}
+
+void Character2DSideScroller::_parallel_character_process(const double p_delta) {
+	const uint64_t frame = Engine::get_singleton()->get_physics_frames();
+	if (parallel_frame != frame) { // first character of this tick evaluates every registered character
+		TRACE_SCOPE("Character2DSideScroller::parallel_group");
+		parallel_frame = frame;
+		// node state is read here, the workers only get plain data
+		for (uint32_t i = 0; i < parallel_characters.size(); ++i) {
+			Character2DSideScroller* character = parallel_characters[i];
+			ParallelTick& tick = character->parallel_tick;
+			tick.frame = frame;
+			tick.settled = false;
+			tick.delta = (character->is_physics_processing_internal() ? character->_peek_lod_delta(p_delta) : 0);
+			if (tick.delta)
+				character->_get_process_source(tick.source);
 		}
+		WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_template_group_task(this, &Character2DSideScroller::_parallel_process_task, p_delta, parallel_characters.size(), -1, true);
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
 	}
-	if (air_state) {
-		set_velocity(states_jumping_movement_data.get(air_state)->get_velocity(get_velocity(), delta));
-		if (is_on_floor()) {
-			set_state(air_state | (unsigned short)(State::STATE_IDLE) | (unsigned short)(State::REVERSE_TRANSITION_BIT_FLAG));
-			_character_process(delta); // transition
+	// decided like a serial tick, a script of an earlier character may have woken this one
+	const double delta = _lod_delta(p_delta);
+	if (!delta)
+		return;
+	// a script callback of an earlier character may have touched this one, then the result is stale
+	if (parallel_tick.frame == frame && parallel_tick.settled && parallel_tick.delta == delta) {
+		ProcessSource source;
+		_get_process_source(source);
+		if (source == parallel_tick.source) {
+			_apply_movement(parallel_tick.result, delta);
+			return;
 		}
+	}
+	_character_process(delta);
+}
+
+void Character2DSideScroller::_parallel_process_task(const uint32_t p_index, const double p_delta) {
+	ALLOCATION_COUNT_SCOPE();
+	Character2DSideScroller* character = parallel_characters[p_index];
+	ParallelTick& tick = character->parallel_tick;
+	tick.settled = tick.delta && character->_process_movement(tick.source, tick.delta, tick.result);
+}
+
+// Returns the delta to process this tick with, 0 while the character skips ticks or sleeps.
+double Character2DSideScroller::_lod_delta(const double delta) {
+	if (!movement_lod)
+		return delta;
+	if (movement_lod->sleeping) {
+		if (state == (unsigned short)(State::STATE_IDLE) && _is_on_floor() && get_velocity() == Vector2())
+			return 0;
+		movement_lod->sleeping = false;
+		movement_lod->accumulated_delta = 0;
+	}
+	movement_lod->accumulated_delta += delta;
+	if ((Engine::get_singleton()->get_physics_frames() + movement_lod->phase) % movement_lod->interval)
+		return 0;
+
+	real_t distance = -1;
+	const Vector2 position = get_global_position();
+	for (uint32_t i = 0; i < lod_observer_positions.size(); ++i) {
+		const real_t d = position.distance_squared_to(lod_observer_positions[i]);
+		if (distance < 0 || d < distance)
+			distance = d;
+	}
+	movement_lod->interval = (distance < 0 || distance <= lod_near_distance * lod_near_distance) ? 1 :
+		(distance <= lod_far_distance * lod_far_distance ? lod_mid_interval : lod_far_interval);
+
+	const double res = movement_lod->accumulated_delta;
+	movement_lod->accumulated_delta = 0;
+	if (state == (unsigned short)(State::STATE_IDLE) && _is_on_floor() && get_velocity() == Vector2()) {
+		movement_lod->sleeping = true;
+		return 0;
+	}
+	return res;
+}
+
+// What _lod_delta returns this tick without advancing the LOD, the parallel phase works ahead with it.
+double Character2DSideScroller::_peek_lod_delta(const double delta) const {
+	if (!movement_lod)
+		return delta;
+	const bool resting = state == (unsigned short)(State::STATE_IDLE) && _is_on_floor() && get_velocity() == Vector2();
+	if ((movement_lod->sleeping && resting) || (Engine::get_singleton()->get_physics_frames() + movement_lod->phase) % movement_lod->interval || resting)
+		return 0;
+	return (movement_lod->sleeping ? 0 : movement_lod->accumulated_delta) + delta;
+}
+
+void Character2DSideScroller::_update_lod_observers() {
+	const uint64_t frame = Engine::get_singleton()->get_physics_frames();
+	if (lod_observer_frame == frame)
 		return;
+	lod_observer_frame = frame;
+	lod_observer_positions.clear();
+	const Camera2D* camera = get_viewport()->get_camera_2d();
+	if (camera)
+		lod_observer_positions.push_back(camera->get_camera_screen_center());
+	for (uint32_t i = 0; i < lod_observers.size();) {
+		const Node2D* observer = Object::cast_to<Node2D>(ObjectDB::get_instance(lod_observers[i]));
+		if (!observer) {
+			lod_observers.remove_at_unordered(i);
+			continue;
+		}
+		lod_observer_positions.push_back(observer->get_global_position());
+		++i;
 	}
 }
 
+// the lists of a movement set are saved with the set, not with every character
+void Character2DSideScroller::_validate_property(PropertyInfo& p_property) const {
+	if (movement_set.is_valid() && (p_property.name == "grounded_movement" || p_property.name == "jumping_movement"))
+		p_property.usage = PROPERTY_USAGE_NONE;
+}
+
 void Character2DSideScroller::_notification(int p_notification) {
 	switch (p_notification) {
 		case NOTIFICATION_INTERNAL_PHYSICS_PROCESS: {
-			_character_process(get_physics_process_delta_time());
+#ifdef MARTHVON_MONITORS
+			_monitor_roll_frame();
+			const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+			_monitor_add(((state >> 5) & 0b1111) ? MONITOR_AIR_TICKS : MONITOR_FLOOR_TICKS, 1);
+#endif
+			interpolation_previous = get_global_position();
+			if (movement_lod || parallel_process)
+				_update_lod_observers();
+			if (parallel_process)
+				_parallel_character_process(get_physics_process_delta_time());
+			else {
+				const double delta = _lod_delta(get_physics_process_delta_time());
+				if (delta)
+					_character_process(delta);
+			}
+			// a skipped or sleeping tick keeps its velocity, the body moves every tick like a script would move it
+			if (auto_move)
+				move_character();
+			floor_override = -1; // scripts move the body after this tick
+			if (ghost_recording.is_valid())
+				ghost_recording->record_character(this);
+#ifdef MARTHVON_MONITORS
+			_monitor_add(MONITOR_TICKS, 1);
+			_monitor_add(MONITOR_PROCESS_USEC, OS::get_singleton()->get_ticks_usec() - begin);
+#endif
 		} break;
+		case NOTIFICATION_INTERNAL_PROCESS:
+			_update_interpolated_visual();
+		break;
+		case NOTIFICATION_READY:
+			_update_visual();
+			update_shape_size(); // shapes of children added by the scene
+		break;
+		case NOTIFICATION_ENABLED: // the body was put back in the space
+			if (kinematic)
+				_update_kinematic_body();
+		break;
+		case NOTIFICATION_ENTER_TREE:
+#ifdef MARTHVON_MONITORS
+			add_performance_monitors();
+#endif
+			if (kinematic)
+				_update_kinematic_body();
+			if (parallel_process)
+				parallel_characters.push_back(this);
+			interpolation_previous = get_global_position();
+			set_physics_process_internal(is_visible_in_tree() && !disable_movement);
+		break;
+		case NOTIFICATION_EXIT_TREE:
+			if (parallel_process)
+				parallel_characters.erase(this);
+		break;
 		case NOTIFICATION_PAUSED:
 			set_physics_process_internal(false);
 		case NOTIFICATION_UNPAUSED:
 			set_physics_process_internal(is_visible_in_tree() && !disable_movement);
-		case NOTIFICATION_ENTER_TREE:
 		case NOTIFICATION_VISIBILITY_CHANGED:
 			set_physics_process_internal(is_visible_in_tree() && !disable_movement);
 	};
 }
 
 void Character2DSideScroller::set_state(const unsigned short p_state) {
+#ifdef MARTHVON_MONITORS
+	if (state != p_state) {
+		_monitor_add(MONITOR_TRANSITIONS, 1);
+		const uint32_t key = (uint32_t(state) << 16) | p_state;
+		uint64_t* count = monitors.transitions.getptr(key);
+		if (count)
+			++(*count);
+		else
+			monitors.transitions.insert(key, 1);
+	}
+#endif
+	const unsigned short previous = state;
 	state = p_state;
+	if (movement_lod)
+		movement_lod->sleeping = false;
+	if (previous != p_state && !state_notifications_suspended)
+		_notify_state_changed(previous, p_state);
 }
 int Character2DSideScroller::get_state() const {
 	return state;
 }
+void Character2DSideScroller::add_state_listener(const Callable& p_callable, const int p_mask) {
+	ERR_FAIL_COND(!p_callable.is_valid());
+	state_listeners_mask = 0;
+	bool found = false;
+	for (uint32_t i = 0; i < state_listeners.size(); ++i) {
+		if (state_listeners[i].callable == p_callable) {
+			state_listeners[i].mask = p_mask;
+			found = true;
+		}
+		state_listeners_mask |= state_listeners[i].mask;
+	}
+	if (found)
+		return;
+	StateListener listener;
+	listener.callable = p_callable;
+	listener.mask = p_mask;
+	state_listeners.push_back(listener);
+	state_listeners_mask |= listener.mask;
+}
+void Character2DSideScroller::remove_state_listener(const Callable& p_callable) {
+	state_listeners_mask = 0;
+	for (uint32_t i = 0; i < state_listeners.size();) {
+		if (state_listeners[i].callable == p_callable) {
+			state_listeners.remove_at(i);
+			continue;
+		}
+		state_listeners_mask |= state_listeners[i].mask;
+		++i;
+	}
+}
+
+// listeners are called in the order they were added, one removed while notified may miss this change
+// listeners whose object was freed or lost the method are dropped, other call errors are reported
+void Character2DSideScroller::_notify_state_changed(const unsigned short p_old_state, const unsigned short p_new_state) {
+	const uint16_t changed = p_old_state ^ p_new_state;
+	if (changed & state_listeners_mask) {
+		const Variant args[2] = { p_old_state, p_new_state };
+		const Variant* argptrs[2] = { &args[0], &args[1] };
+		bool prune = false;
+		for (uint32_t i = 0; i < state_listeners.size(); ++i) {
+			if (!(changed & state_listeners[i].mask))
+				continue;
+			const Callable callable = state_listeners[i].callable; // the listener may remove itself
+			Callable::CallError ce;
+			if (callable.is_valid()) {
+				Variant ret;
+				callable.callp(argptrs, 2, ret, ce);
+			} else
+				ce.error = Callable::CallError::CALL_ERROR_INSTANCE_IS_NULL;
+			if (ce.error == Callable::CallError::CALL_OK)
+				continue;
+			if (ce.error != Callable::CallError::CALL_ERROR_INSTANCE_IS_NULL && ce.error != Callable::CallError::CALL_ERROR_INVALID_METHOD) {
+				ERR_PRINT("State listener failed: " + Variant::get_callable_error_text(callable, argptrs, 2, ce) + ".");
+				continue;
+			}
+			// a mask of 0 never fires, pruned below
+			if (i < state_listeners.size() && state_listeners[i].callable == callable)
+				state_listeners[i].mask = 0;
+			prune = true;
+		}
+		if (prune) {
+			state_listeners_mask = 0;
+			for (uint32_t i = 0; i < state_listeners.size();) {
+				if (!state_listeners[i].mask || !state_listeners[i].callable.is_valid()) {
+					state_listeners.remove_at(i);
+					continue;
+				}
+				state_listeners_mask |= state_listeners[i].mask;
+				++i;
+			}
+		}
+	}
+	emit_signal(SNAME("state_changed"), p_old_state, p_new_state);
+}
 void Character2DSideScroller::set_grounded_movement_data(const Array& p_list) {
 	if (p_list.size() >= 16)
 		return;
+	if (movement_set.is_valid()) {
+		movement_set.unref();
+		notify_property_list_changed();
+	}
+	++movement_version;
 	states_grounded_movement_data.clear();
 	states_grounded_movement_data.resize(p_list.size());
 	for (int i = 0; i != p_list.size(); ++i)
-		states_grounded_movement_data.push_back(Ref<GroundedMovementData1D>(Object::cast_to<GroundedMovementData1D>(p_list.get(i))));
+		states_grounded_movement_data.set(i, Ref<GroundedMovementData1D>(Object::cast_to<GroundedMovementData1D>(p_list.get(i))));
 }
 Array Character2DSideScroller::get_grounded_movement_data() const {
 	Array res;
-	res.resize(states_grounded_movement_data.size());
 	for (auto i = states_grounded_movement_data.begin(); i != states_grounded_movement_data.end(); ++i)
 		res.push_back(Variant(**i));
 
@@ -145,19 +596,39 @@ Array Character2DSideScroller::get_grounded_movement_data() const {
 void Character2DSideScroller::set_jumping_movement_data(const Array& p_list) {
 	if (p_list.size() >= 16)
 		return;
+	if (movement_set.is_valid()) {
+		movement_set.unref();
+		notify_property_list_changed();
+	}
+	++movement_version;
 	states_jumping_movement_data.clear();
 	states_jumping_movement_data.resize(p_list.size());
 	for (int i = 0; i != p_list.size(); ++i)
-		states_jumping_movement_data.push_back(Ref<GroundedMovementData1D>(Object::cast_to<GroundedMovementData1D>(p_list.get(i))));
+		states_jumping_movement_data.set(i, Ref<MovementData2D>(Object::cast_to<MovementData2D>(p_list.get(i))));
 }
 Array Character2DSideScroller::get_jumping_movement_data() const {
 	Array res;
-	res.resize(states_jumping_movement_data.size());
 	for (auto i = states_jumping_movement_data.begin(); i != states_jumping_movement_data.end(); ++i)
 		res.push_back(Variant(**i));
 
 	return res;
 }
+// the vectors are copy on write, every character holds the same movement data and nothing is copied
+void Character2DSideScroller::set_movement_set(const Ref<MovementSet>& p_set) {
+	movement_set = p_set;
+	++movement_version;
+	if (movement_set.is_valid()) {
+		states_grounded_movement_data = movement_set->get_grounded();
+		states_jumping_movement_data = movement_set->get_jumping();
+	} else {
+		states_grounded_movement_data.clear();
+		states_jumping_movement_data.clear();
+	}
+	notify_property_list_changed();
+}
+Ref<MovementSet> Character2DSideScroller::get_movement_set() const {
+	return movement_set;
+}
 void Character2DSideScroller::toggle_movement_disable(const bool p_disable) {
 	set_physics_process_internal(!p_disable);
 	disable_movement = p_disable;
@@ -190,14 +661,475 @@ bool Character2DSideScroller::is_facing_right() const {
 }
 void Character2DSideScroller::set_character_path(const NodePath p_path) {
 	character_path = p_path;
+	if (is_inside_tree())
+		_update_visual();
 }
 NodePath Character2DSideScroller::get_character_path() const {
 	return character_path;
 }
+void Character2DSideScroller::toggle_parallel_process(const bool p_parallel) {
+	if (parallel_process == p_parallel)
+		return;
+	parallel_process = p_parallel;
+	if (!is_inside_tree())
+		return;
+	if (p_parallel)
+		parallel_characters.push_back(this);
+	else
+		parallel_characters.erase(this);
+}
+bool Character2DSideScroller::is_parallel_process() const {
+	return parallel_process;
+}
+void Character2DSideScroller::toggle_movement_lod(const bool p_lod) {
+	if (p_lod == (movement_lod != nullptr))
+		return;
+	if (!p_lod) {
+		delete movement_lod;
+		movement_lod = nullptr;
+		return;
+	}
+	movement_lod = new Character2DSideScroller::MovementLOD();
+	movement_lod->phase = lod_phase_counter++;
+}
+bool Character2DSideScroller::is_movement_lod() const {
+	return movement_lod;
+}
+void Character2DSideScroller::wake_up() {
+	if (movement_lod)
+		movement_lod->sleeping = false;
+}
+bool Character2DSideScroller::is_sleeping() const {
+	return movement_lod && movement_lod->sleeping;
+}
+
+void Character2DSideScroller::add_lod_observer(Node* p_observer) {
+	ERR_FAIL_NULL(p_observer);
+	if (lod_observers.find(p_observer->get_instance_id()) == -1)
+		lod_observers.push_back(p_observer->get_instance_id());
+}
+void Character2DSideScroller::remove_lod_observer(Node* p_observer) {
+	ERR_FAIL_NULL(p_observer);
+	lod_observers.erase(p_observer->get_instance_id());
+}
+void Character2DSideScroller::set_lod_distances(const real_t p_near, const real_t p_far) {
+	lod_near_distance = MAX(p_near, 0.0);
+	lod_far_distance = MAX(p_far, lod_near_distance);
+}
+void Character2DSideScroller::set_lod_intervals(const int p_mid_interval, const int p_far_interval) {
+	lod_mid_interval = CLAMP(p_mid_interval, 1, 255);
+	lod_far_interval = CLAMP(p_far_interval, lod_mid_interval, 255);
+}
+
+void Character2DSideScroller::toggle_interpolate_visual(const bool p_interpolate) {
+	interpolate_visual = p_interpolate;
+	if (is_inside_tree())
+		_update_visual();
+}
+bool Character2DSideScroller::is_interpolate_visual() const {
+	return interpolate_visual;
+}
+void Character2DSideScroller::teleport(const Vector2 p_position) {
+	set_global_position(p_position);
+	reset_interpolation();
+}
+// Back to how it spawned at the position, movement data and the script instance stay bound.
+void Character2DSideScroller::reset_character(const Vector2 p_position, const bool p_facing_right) {
+	set_state((unsigned short)State::STATE_IDLE); // the jump counter is part of the state
+	set_velocity(Vector2());
+	exact_velocity = Vector2();
+	exact_applied_velocity = Vector2();
+	isFacingRight = p_facing_right;
+	floor_override = -1;
+	if (kinematic)
+		kinematic->on_floor = kinematic->on_wall = kinematic->on_ceiling = false;
+	for (uint32_t i = 0; i < snapshots.size(); ++i)
+		snapshots[i].tick = -1;
+	teleport(p_position);
+}
+void Character2DSideScroller::reset_interpolation() {
+	interpolation_previous = get_global_position();
+	_update_interpolated_visual();
+}
+
+void Character2DSideScroller::_update_visual() {
+	Node2D* previous_visual = Object::cast_to<Node2D>(ObjectDB::get_instance(visual));
+	if (previous_visual)
+		_set_visual_offset(previous_visual, Vector2());
+	visual_offset = Vector2();
+	Node2D* node = (interpolate_visual ? Object::cast_to<Node2D>(get_node_or_null(character_path)) : nullptr);
+	visual = node ? node->get_instance_id() : ObjectID();
+	interpolation_previous = get_global_position();
+	set_process_internal(node);
+}
+
+void Character2DSideScroller::_update_interpolated_visual() {
+	Node2D* node = Object::cast_to<Node2D>(ObjectDB::get_instance(visual));
+	if (!node)
+		return;
+	bool interpolate = is_physics_processing_internal();
+#if VERSION_MAJOR > 4 || (VERSION_MAJOR == 4 && VERSION_MINOR >= 3)
+	if (interpolate && get_tree()->is_physics_interpolation_enabled()) // the engine already interpolates the body
+		interpolate = false;
+#endif
+	if (!interpolate) {
+		_set_visual_offset(node, Vector2());
+		return;
+	}
+	const Vector2 current = get_global_position();
+	const Vector2 interpolated = interpolation_previous.lerp(current, Engine::get_singleton()->get_physics_interpolation_fraction());
+	// the offset is written to the visual's local position, it is in the space of the visual's parent
+	const CanvasItem* parent = Object::cast_to<CanvasItem>(node->get_parent());
+	const Vector2 offset = interpolated - current;
+	_set_visual_offset(node, parent ? parent->get_global_transform().affine_inverse().basis_xform(offset) : offset);
+}
+
+// only the change of the offset is written, animations and scripts moving the visual keep their motion
+void Character2DSideScroller::_set_visual_offset(Node2D* p_node, const Vector2 p_offset) {
+	if (p_offset == visual_offset)
+		return;
+	p_node->set_position(p_node->get_position() - visual_offset + p_offset);
+	visual_offset = p_offset;
+}
+
+void Character2DSideScroller::toggle_exact_integration(const bool p_exact) {
+	exact_integration = p_exact;
+	++movement_version;
+	exact_velocity = get_velocity();
+	exact_applied_velocity = get_velocity();
+}
+bool Character2DSideScroller::is_exact_integration() const {
+	return exact_integration;
+}
+void Character2DSideScroller::set_ghost_recording(const Ref<GhostRecording>& p_recording) {
+	ghost_recording = p_recording;
+}
+Ref<GhostRecording> Character2DSideScroller::get_ghost_recording() const {
+	return ghost_recording;
+}
+
+void Character2DSideScroller::set_kinematic_grid(const Ref<TileOccupancyGrid2D>& p_grid) {
+	if (p_grid.is_null()) {
+		if (!kinematic)
+			return;
+		delete kinematic;
+		kinematic = nullptr;
+		_update_kinematic_body();
+		return;
+	}
+	if (!kinematic) {
+		kinematic = new Kinematic();
+		kinematic->on_floor = is_on_floor();
+		kinematic->box = _get_shapes_rect();
+	}
+	kinematic->grid = p_grid;
+	_update_kinematic_body();
+}
+Ref<TileOccupancyGrid2D> Character2DSideScroller::get_kinematic_grid() const {
+	return kinematic ? kinematic->grid : Ref<TileOccupancyGrid2D>();
+}
+
+// the box is read from the shapes once, shapes changed afterwards need another call
+void Character2DSideScroller::update_kinematic_box() {
+	ERR_FAIL_NULL_MSG(kinematic, "The character isn't kinematic.");
+	kinematic->box = _get_shapes_rect();
+}
+void Character2DSideScroller::update_shape_size() {
+	const Rect2 rect = _get_shapes_rect();
+	if (kinematic)
+		kinematic->box = rect;
+	substep_length = MIN(rect.size.x, rect.size.y) * substep_fraction;
+}
+Rect2 Character2DSideScroller::_get_shapes_rect() const {
+	List<uint32_t> owners;
+	get_shape_owners(&owners);
+	Rect2 res;
+	bool first = true;
+	for (const uint32_t owner : owners) {
+		if (is_shape_owner_disabled(owner))
+			continue;
+		const Transform2D xform = shape_owner_get_transform(owner);
+		for (int i = 0; i < shape_owner_get_shape_count(owner); ++i) {
+			const Rect2 rect = xform.xform(shape_owner_get_shape(owner, i)->get_rect());
+			res = (first ? rect : res.merge(rect));
+			first = false;
+		}
+	}
+	return res;
+}
 
+void Character2DSideScroller::set_substep_fraction(const real_t p_fraction) {
+	ERR_FAIL_COND(p_fraction < 0);
+	substep_fraction = p_fraction;
+	if (is_inside_tree())
+		update_shape_size();
+}
+real_t Character2DSideScroller::get_substep_fraction() const {
+	return substep_fraction;
+}
+void Character2DSideScroller::set_max_substeps(const int p_substeps) {
+	ERR_FAIL_COND(p_substeps < 1 || p_substeps > 255);
+	max_substeps = p_substeps;
+}
+int Character2DSideScroller::get_max_substeps() const {
+	return max_substeps;
+}
+void Character2DSideScroller::toggle_auto_move(const bool p_auto_move) {
+	auto_move = p_auto_move;
+}
+bool Character2DSideScroller::is_auto_move() const {
+	return auto_move;
+}
+// slow characters take one step, a step never moves further than the substep length unless max_substeps runs out
+int Character2DSideScroller::get_substep_count() const {
+	if (substep_length <= 0)
+		return 1;
+	const real_t distance = get_velocity().length() * get_physics_process_delta_time();
+	if (distance <= substep_length)
+		return 1;
+	return MIN((int)Math::ceil(distance / substep_length), (int)max_substeps);
+}
 
-bool Character2DSideScroller::_call_script_instance(const String& p_method, const double delta) {
-	if (get_script_instance()->has_method(p_method))
+// Kinematic characters leave the physics space and stop syncing their transform to the server.
+void Character2DSideScroller::_update_kinematic_body() {
+	set_notify_transform(!kinematic);
+	if (!is_inside_tree())
+		return;
+	PhysicsServer2D* physics = PhysicsServer2D::get_singleton();
+	if (kinematic) {
+		physics->body_set_space(get_rid(), RID());
+		return;
+	}
+	physics->body_set_state(get_rid(), PhysicsServer2D::BODY_STATE_TRANSFORM, get_global_transform());
+	if (can_process() || get_disable_mode() != DISABLE_MODE_REMOVE)
+		physics->body_set_space(get_rid(), get_world_2d()->get_space());
+}
+
+// With auto_move the tick moves the body right after the state machine set the velocity, no script changes needed.
+// Without it moving stays with the script, which calls this in place of move_and_slide to substep. resimulate moves with it.
+bool Character2DSideScroller::move_character() {
+	const double delta = get_physics_process_delta_time();
+	const int steps = get_substep_count();
+	if (kinematic) {
+		bool collided = false;
+		for (int i = 0; i < steps; ++i)
+			collided |= _move_kinematic(delta / steps);
+		return collided;
+	}
+	// a moving platform would carry the character once per step
+	if (steps == 1 || get_platform_velocity() != Vector2())
+		return move_and_slide();
+	TRACE_SCOPE("Character2DSideScroller::substeps");
+	// move_and_slide reads the tick delta itself, every step moves with a fraction of the velocity
+	bool collided = false;
+	set_velocity(get_velocity() / steps);
+	for (int i = 0; i < steps; ++i)
+		collided |= move_and_slide();
+	set_velocity(get_velocity() * steps);
+	return collided;
+}
+
+// Moves along x then y, each axis stops at the first solid cell. The floor is probed like move_and_slide snaps to it.
+bool Character2DSideScroller::_move_kinematic(const double delta) {
+	const TileOccupancyGrid2D* grid = kinematic->grid.ptr();
+	const bool was_on_floor = kinematic->on_floor;
+	Vector2 velocity = get_velocity();
+	const Vector2 motion = velocity * delta;
+	Rect2 box = Rect2(get_global_position() + kinematic->box.position, kinematic->box.size);
+	kinematic->on_floor = kinematic->on_wall = kinematic->on_ceiling = false;
+
+	const real_t x = grid->sweep(box, Vector2::AXIS_X, motion.x);
+	box.position.x += x;
+	if (x != motion.x) {
+		velocity.x = 0;
+		kinematic->on_wall = true;
+	}
+	const real_t y = grid->sweep(box, Vector2::AXIS_Y, motion.y);
+	box.position.y += y;
+	if (y != motion.y) {
+		velocity.y = 0;
+		if (motion.y > 0)
+			kinematic->on_floor = true;
+		else
+			kinematic->on_ceiling = true;
+	}
+	if (!kinematic->on_floor && motion.y >= 0) {
+		const real_t probe = (was_on_floor ? MAX(get_floor_snap_length(), kinematic_floor_probe) : kinematic_floor_probe);
+		const real_t drop = grid->sweep(box, Vector2::AXIS_Y, probe);
+		if (drop < probe) {
+			box.position.y += drop;
+			velocity.y = MIN(velocity.y, (real_t)0);
+			kinematic->on_floor = true;
+		}
+	}
+	set_velocity(velocity);
+	set_global_position(box.position - kinematic->box.position);
+	return kinematic->on_wall || y != motion.y;
+}
+
+bool Character2DSideScroller::is_character_on_floor() const {
+	return _is_on_floor();
+}
+bool Character2DSideScroller::is_character_on_wall() const {
+	return kinematic ? kinematic->on_wall : is_on_wall();
+}
+bool Character2DSideScroller::is_character_on_ceiling() const {
+	return kinematic ? kinematic->on_ceiling : is_on_ceiling();
+}
+
+void Character2DSideScroller::set_rollback_capacity(const int p_capacity) {
+	ERR_FAIL_COND(p_capacity < 0);
+	snapshots.clear();
+	snapshots.resize(p_capacity);
+}
+int Character2DSideScroller::get_rollback_capacity() const {
+	return snapshots.size();
+}
+void Character2DSideScroller::write_snapshot(Snapshot& r_snapshot) const {
+	r_snapshot.position = get_global_position();
+	r_snapshot.velocity = get_velocity();
+	r_snapshot.exact_velocity = exact_velocity;
+	r_snapshot.exact_applied_velocity = exact_applied_velocity;
+	r_snapshot.state = state;
+	r_snapshot.on_floor = _is_on_floor();
+	r_snapshot.facing_right = isFacingRight;
+}
+void Character2DSideScroller::read_snapshot(const Snapshot& p_snapshot) {
+	set_global_position(p_snapshot.position);
+	set_velocity(p_snapshot.velocity);
+	exact_velocity = p_snapshot.exact_velocity;
+	exact_applied_velocity = p_snapshot.exact_applied_velocity;
+	set_state(p_snapshot.state);
+	floor_override = p_snapshot.on_floor;
+	isFacingRight = p_snapshot.facing_right;
+}
+const Character2DSideScroller::Snapshot* Character2DSideScroller::get_snapshot(const int64_t p_tick) const {
+	if (snapshots.is_empty() || p_tick < 0)
+		return nullptr;
+	const Snapshot& snapshot = snapshots[p_tick % snapshots.size()];
+	return snapshot.tick == p_tick ? &snapshot : nullptr;
+}
+void Character2DSideScroller::save_state(const int64_t p_tick) {
+	ERR_FAIL_COND_MSG(snapshots.is_empty(), "rollback_capacity is 0.");
+	ERR_FAIL_COND(p_tick < 0);
+	Snapshot& snapshot = snapshots[p_tick % snapshots.size()];
+	write_snapshot(snapshot);
+	snapshot.tick = p_tick;
+}
+bool Character2DSideScroller::restore_state(const int64_t p_tick) {
+	const Snapshot* snapshot = get_snapshot(p_tick);
+	ERR_FAIL_NULL_V_MSG(snapshot, false, "Tick " + itos(p_tick) + " is no longer in the rollback buffer.");
+	read_snapshot(*snapshot);
+	return true;
+}
+// the tick of NOTIFICATION_INTERNAL_PHYSICS_PROCESS with auto_move, without the LOD or the parallel phase
+bool Character2DSideScroller::resimulate(const int64_t p_from_tick, const PackedInt32Array& p_inputs) {
+	const unsigned short notified_state = state;
+	state_notifications_suspended = true;
+	if (!restore_state(p_from_tick)) {
+		state_notifications_suspended = false;
+		return false;
+	}
+	const double delta = get_physics_process_delta_time();
+	for (int i = 0; i < p_inputs.size(); ++i) {
+		if (p_inputs[i] >= 0)
+			set_state(p_inputs[i]);
+		_character_process(delta);
+		move_character();
+		floor_override = -1;
+		save_state(p_from_tick + 1 + i);
+	}
+	state_notifications_suspended = false;
+	if (state != notified_state)
+		_notify_state_changed(notified_state, state);
+	return true;
+}
+
+Character2DSideScroller::~Character2DSideScroller() {
+	if (movement_lod)
+		delete movement_lod;
+	if (kinematic)
+		delete kinematic;
+}
+
+
+bool Character2DSideScroller::_call_script_instance(const StringName& p_method, const double delta) {
+	if (get_script_instance() && get_script_instance()->has_method(p_method)) {
+		TRACE_SCOPE("Character2DSideScroller::_call_script_instance");
+#ifdef MARTHVON_MONITORS
+		const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		const bool res = get_script_instance()->call(p_method, delta);
+		_monitor_add(MONITOR_SCRIPT_CALLS, 1);
+		_monitor_add(MONITOR_SCRIPT_USEC, OS::get_singleton()->get_ticks_usec() - begin);
+		return res;
+#else
 		return get_script_instance()->call(p_method, delta);
+#endif
+	}
 	return true;
 }
+
+#ifdef MARTHVON_MONITORS
+static const char* monitor_names[Character2DSideScroller::MONITOR_MAX] = {
+	"Character2DSideScroller/ticks",
+	"Character2DSideScroller/process_usec",
+	"Character2DSideScroller/script_calls",
+	"Character2DSideScroller/script_usec",
+	"Character2DSideScroller/transitions",
+	"Character2DSideScroller/floor_ticks",
+	"Character2DSideScroller/air_ticks",
+};
+
+void Character2DSideScroller::_monitor_roll_frame() {
+	const uint64_t frame = Engine::get_singleton()->get_physics_frames();
+	if (monitor_frame == frame)
+		return;
+	monitor_frame = frame;
+	for (int i = 0; i < MONITOR_MAX; ++i) {
+		monitor_last_frame_values[i] = monitor_frame_values[i];
+		monitor_frame_values[i] = 0;
+	}
+}
+uint64_t Character2DSideScroller::_get_performance_monitor(const int p_monitor) {
+	ERR_FAIL_INDEX_V(p_monitor, MONITOR_MAX, 0);
+	// nothing ticked since the last rollover, the last frame is not representative anymore
+	if (monitor_frame + 1 < Engine::get_singleton()->get_physics_frames())
+		return 0;
+	return monitor_last_frame_values[p_monitor];
+}
+
+void Character2DSideScroller::add_performance_monitors() {
+	Performance* performance = Performance::get_singleton();
+	if (monitors_registered || !performance)
+		return;
+	monitors_registered = true;
+	for (int i = 0; i < MONITOR_MAX; ++i)
+		performance->add_custom_monitor(monitor_names[i], callable_mp_static(&Character2DSideScroller::_get_performance_monitor), varray(i));
+}
+void Character2DSideScroller::remove_performance_monitors() {
+	Performance* performance = Performance::get_singleton();
+	if (!monitors_registered || !performance)
+		return;
+	monitors_registered = false;
+	for (int i = 0; i < MONITOR_MAX; ++i) {
+		if (performance->has_custom_monitor(monitor_names[i]))
+			performance->remove_custom_monitor(monitor_names[i]);
+	}
+}
+
+Dictionary Character2DSideScroller::get_monitors() const {
+	Dictionary res;
+	for (int i = 0; i < MONITOR_MAX; ++i)
+		res[String(monitor_names[i]).get_file()] = monitors.values[i];
+	Dictionary transitions;
+	for (const KeyValue<uint32_t, uint64_t>& E : monitors.transitions)
+		transitions[Vector2i(E.key >> 16, E.key & 0xFFFF)] = E.value;
+	res["transition_pairs"] = transitions;
+	return res;
+}
+void Character2DSideScroller::reset_monitors() {
+	for (int i = 0; i < MONITOR_MAX; ++i)
+		monitors.values[i] = 0;
+	monitors.transitions.clear();
+}
+#endif
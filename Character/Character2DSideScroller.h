@@ -2,8 +2,15 @@
 #define CHARACTER_2D_SIDE_SCROLLER
 
 #include "scene/2d/physics_body_2d.h"
+#include "core/templates/local_vector.h"
+#ifdef MARTHVON_MONITORS
+#include "core/templates/hash_map.h"
+#endif
 #include "GroundedMovementData1D.h"
 #include "MovementData2D.h"
+#include "MovementSet.h"
+#include "TileOccupancyGrid2D.h"
+#include "../Bitwise/GhostRecording.h"
 
 class Character2DSideScroller : public CharacterBody2D {
 	GDCLASS(Character2DSideScroller, CharacterBody2D);
@@ -22,6 +29,26 @@ public:
 		REVERSE_TRANSITION_BIT_FLAG = (1 << 9)
 		//Custom States starting from bit flag (1 << 10) == 1024
 	};
+	// bit fields of the state, a state listener only hears changes within its mask
+	enum StateMask {
+		STATE_MASK_IDLE = 1,
+		STATE_MASK_GROUNDED = (0b1111 << 1),
+		STATE_MASK_AIR = (0b1111 << 5), // holds the jump counter too
+		STATE_MASK_REVERSE_TRANSITION = (1 << 9),
+		STATE_MASK_CUSTOM = (0b111111 << 10),
+		STATE_MASK_ALL = 0xFFFF
+	};
+
+	struct Snapshot { //jump counter is part of the state bits
+		Vector2 position = Vector2();
+		Vector2 velocity = Vector2();
+		Vector2 exact_velocity = Vector2(); // integrator state of exact_integration, equal to velocity continues from it
+		Vector2 exact_applied_velocity = Vector2();
+		int64_t tick = -1;
+		unsigned short state = (unsigned short)State::STATE_IDLE;
+		bool on_floor = false;
+		bool facing_right = true;
+	};
 
 private:
 	NodePath character_path = NodePath();
@@ -30,20 +57,147 @@ private:
 	unsigned short state = (unsigned short)State::STATE_IDLE;
 	bool disable_movement = false;
 
+	struct StateListener {
+		Callable callable;
+		uint16_t mask = STATE_MASK_ALL;
+	};
+	LocalVector<StateListener> state_listeners;
+	uint16_t state_listeners_mask = 0; // union of every listener mask, most changes are skipped with it
+	bool state_notifications_suspended = false; // a resimulation only notifies where it ended
+
 	Vector<Ref<GroundedMovementData1D>> states_grounded_movement_data;
 	Vector<Ref<MovementData2D>> states_jumping_movement_data;
+	Ref<MovementSet> movement_set; // both lists share its vectors instead of holding their own
 
 	uint8_t max_jump_count = 1;
 	real_t friction = 0;
 
+	uint32_t movement_version = 0; // bumped whenever what a tick integrates with changes
+
+	// everything a settled tick reads from the node, copied on the main thread
+	struct ProcessSource {
+		Vector2 velocity = Vector2();
+		Vector2 previous_velocity = Vector2();
+		Vector2 position = Vector2();
+		uint32_t movement_version = 0;
+		unsigned short state = 0;
+		bool on_floor = false;
+
+		bool operator==(const ProcessSource& p_other) const {
+			return velocity == p_other.velocity && previous_velocity == p_other.previous_velocity && position == p_other.position &&
+				movement_version == p_other.movement_version && state == p_other.state && on_floor == p_other.on_floor;
+		}
+	};
+	struct ProcessResult {
+		Vector2 velocity = Vector2();
+		Vector2 exact_velocity = Vector2();
+		unsigned short state = 0;
+		bool transition = false; // landed, the reverse transition still has to go through the script instance
+	};
+	struct ParallelTick {
+		ProcessSource source;
+		ProcessResult result;
+		uint64_t frame = 0;
+		double delta = 0;
+		bool settled = false;
+	} parallel_tick;
+	bool parallel_process = false;
+
+	static LocalVector<Character2DSideScroller*> parallel_characters;
+	static uint64_t parallel_frame;
+
+	struct MovementLOD {
+		double accumulated_delta = 0;
+		uint32_t phase = 0; // spreads characters sharing an interval evenly across frames
+		uint8_t interval = 1;
+		bool sleeping = false;
+	} * movement_lod = nullptr;
+
+	struct Kinematic {
+		Ref<TileOccupancyGrid2D> grid;
+		Rect2 box = Rect2(); // of the collision shapes, relative to the position
+		bool on_floor = false;
+		bool on_wall = false;
+		bool on_ceiling = false;
+	} * kinematic = nullptr; // the body is out of the physics space while a grid replaces it
+
+	real_t substep_fraction = 0.5; // of the smaller side of the shapes a step may move, 0 always moves in one step
+	uint8_t max_substeps = 8;
+	bool auto_move = false; // the tick moves the body with move_character, scripts then only set state
+	real_t substep_length = 0; // the fraction of the shapes, read with the shapes
+
+	static LocalVector<ObjectID> lod_observers;
+	static LocalVector<Vector2> lod_observer_positions;
+	static uint64_t lod_observer_frame;
+	static uint32_t lod_phase_counter;
+	static real_t lod_near_distance;
+	static real_t lod_far_distance;
+	static uint8_t lod_mid_interval;
+	static uint8_t lod_far_interval;
+
+	bool interpolate_visual = true;
+	ObjectID visual; // node at character_path, offset between the previous and current physics positions
+	Vector2 visual_offset = Vector2(); // applied on top of whatever else moves the visual, taken back before the next one
+	Vector2 interpolation_previous = Vector2();
+
+	bool exact_integration = false;
+	Vector2 exact_velocity = Vector2(); // velocity at the end of the last tick, the body moved with the average
+	Vector2 exact_applied_velocity = Vector2();
+
+	Ref<GhostRecording> ghost_recording; // appended to after every tick
+
+	LocalVector<Snapshot> snapshots; // ring buffer, a tick is stored at tick % capacity
+	int8_t floor_override = -1; // floor contact of a restored snapshot until the body moves again
+
+#ifdef MARTHVON_MONITORS
+public:
+	enum Monitor {
+		MONITOR_TICKS,
+		MONITOR_PROCESS_USEC,
+		MONITOR_SCRIPT_CALLS,
+		MONITOR_SCRIPT_USEC,
+		MONITOR_TRANSITIONS,
+		MONITOR_FLOOR_TICKS,
+		MONITOR_AIR_TICKS,
+		MONITOR_MAX
+	};
+private:
+	struct Monitors {
+		uint64_t values[MONITOR_MAX] = {};
+		HashMap<uint32_t, uint64_t> transitions; // (from << 16) | to
+	} monitors;
+
+	// totals of every character, rolled over once per physics frame for the Performance monitors
+	static uint64_t monitor_frame_values[MONITOR_MAX];
+	static uint64_t monitor_last_frame_values[MONITOR_MAX];
+	static uint64_t monitor_frame;
+	static bool monitors_registered;
+
+	_FORCE_INLINE_ void _monitor_add(const Monitor p_monitor, const uint64_t p_value) {
+		monitors.values[p_monitor] += p_value;
+		monitor_frame_values[p_monitor] += p_value;
+	}
+	static void _monitor_roll_frame();
+	static uint64_t _get_performance_monitor(const int p_monitor);
+public:
+	static void add_performance_monitors();
+	static void remove_performance_monitors();
+
+	Dictionary get_monitors() const;
+	void reset_monitors();
+#endif
+
 protected:
 	void _notification(int p_notification);
+	void _validate_property(PropertyInfo& p_property) const;
 	static void _bind_methods();
 public:
 	void set_grounded_movement_data(const Array& p_list);
 	Array get_grounded_movement_data() const;
 	void set_jumping_movement_data(const Array& p_list);
 	Array get_jumping_movement_data() const;
+	void set_movement_set(const Ref<MovementSet>& p_set);
+	Ref<MovementSet> get_movement_set() const;
 	//
 	void set_max_jump_count(const unsigned short int p_count);
 	int get_max_jump_count() const;
@@ -55,19 +209,102 @@ public:
 	bool is_movement_disable() const;
 	void set_state(const unsigned short p_state);
 	int get_state() const;
+	void add_state_listener(const Callable& p_callable, const int p_mask = STATE_MASK_ALL); // called with the old and new state
+	void remove_state_listener(const Callable& p_callable);
 
 	void toggle_facing_right(const bool p_is_right);
 	bool is_facing_right() const;
 
 	void set_character_path(const NodePath p_path);
 	NodePath get_character_path() const;
+
+	void toggle_parallel_process(const bool p_parallel);
+	bool is_parallel_process() const;
+
+	void toggle_movement_lod(const bool p_lod);
+	bool is_movement_lod() const;
+	void wake_up();
+	bool is_sleeping() const;
+
+	static void add_lod_observer(Node* p_observer);
+	static void remove_lod_observer(Node* p_observer);
+	static void set_lod_distances(const real_t p_near, const real_t p_far);
+	static void set_lod_intervals(const int p_mid_interval, const int p_far_interval);
+
+	void toggle_interpolate_visual(const bool p_interpolate);
+	bool is_interpolate_visual() const;
+	void teleport(const Vector2 p_position);
+	void reset_character(const Vector2 p_position, const bool p_facing_right);
+	void reset_interpolation();
+
+	void toggle_exact_integration(const bool p_exact);
+	bool is_exact_integration() const;
+	void set_ghost_recording(const Ref<GhostRecording>& p_recording);
+	Ref<GhostRecording> get_ghost_recording() const;
+
+	void set_kinematic_grid(const Ref<TileOccupancyGrid2D>& p_grid);
+	Ref<TileOccupancyGrid2D> get_kinematic_grid() const;
+	void update_kinematic_box();
+	void update_shape_size(); // the kinematic box and the substep length, read from the shapes
+	void set_substep_fraction(const real_t p_fraction);
+	real_t get_substep_fraction() const;
+	void set_max_substeps(const int p_substeps);
+	int get_max_substeps() const;
+	int get_substep_count() const; // steps the current velocity takes this tick
+	void toggle_auto_move(const bool p_auto_move);
+	bool is_auto_move() const;
+	// Called by the tick itself with auto_move, otherwise by the script in place of move_and_slide, which never substeps.
+	bool move_character(); // move_and_slide, or a sweep against the kinematic grid, in substeps while fast
+	bool is_character_on_floor() const;
+	bool is_character_on_wall() const;
+	bool is_character_on_ceiling() const;
+
+	void set_rollback_capacity(const int p_capacity);
+	int get_rollback_capacity() const;
+	void write_snapshot(Snapshot& r_snapshot) const;
+	void read_snapshot(const Snapshot& p_snapshot);
+	const Snapshot* get_snapshot(const int64_t p_tick) const;
+	void save_state(const int64_t p_tick);
+	bool restore_state(const int64_t p_tick);
+	// Replays the character's own ticks, script transition callbacks included, and moves with move_character after each.
+	// It matches live play exactly with auto_move; a script moving the body itself in _physics_process isn't replayed.
+	bool resimulate(const int64_t p_from_tick, const PackedInt32Array& p_inputs); // input is the state set before each tick, -1 keeps it
+
+	~Character2DSideScroller();
 private:
 	void _character_process(const double delta);
+	void _get_process_source(ProcessSource& r_source) const;
+	bool _process_movement(const ProcessSource& p_source, const double delta, ProcessResult& r_result) const;
+	void _apply_movement(const ProcessResult& p_result, const double delta);
+	void _process_transition(const double delta);
+	_FORCE_INLINE_ Vector2 _get_previous_velocity() const;
+	_FORCE_INLINE_ Vector2 _integrate(const GroundedMovementData1D* p_data, const Vector2 p_previous, const double delta, const bool transitioning, Vector2& r_exact_velocity) const;
+	void _transition_velocity(const GroundedMovementData1D* p_data, const double delta);
+
+	void _parallel_character_process(const double delta);
+	void _parallel_process_task(const uint32_t p_index, const double delta);
+
+	_FORCE_INLINE_ bool _is_on_floor() const { return floor_override == -1 ? (kinematic ? kinematic->on_floor : is_on_floor()) : floor_override; }
+	void _update_kinematic_body();
+	bool _move_kinematic(const double delta);
+	Rect2 _get_shapes_rect() const;
+
+	void _notify_state_changed(const unsigned short p_old_state, const unsigned short p_new_state);
+
+	void _update_visual();
+	void _update_interpolated_visual();
+	void _set_visual_offset(Node2D* p_node, const Vector2 p_offset);
+
+	double _lod_delta(const double delta);
+	double _peek_lod_delta(const double delta) const;
+	void _update_lod_observers();
 
 	inline void transition(const uint8_t from_state, const uint8_t to_state, const bool reverse_transition, const double delta);
 	inline void _transitioning_states(const uint8_t from_state, const uint8_t to_state, const bool reverse_transition, const double delta);
 	inline void _transition_custom_states(const uint8_t state, const uint8_t custom_state, const bool reverse_transition, const double delta);
-	inline bool _call_script_instance(const String& p_method, const double delta);
+	inline bool _call_script_instance(const StringName& p_method, const double delta);
 };
 
+VARIANT_ENUM_CAST(Character2DSideScroller::StateMask);
+
 #endif
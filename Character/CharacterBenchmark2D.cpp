@@ -0,0 +1,459 @@
+#include "CharacterBenchmark2D.h"
+
+#ifdef MARTHVON_BENCHMARK
+
+#include "core/config/engine.h"
+#include "core/input/input_map.h"
+#include "core/os/os.h"
+#include "core/templates/hashfuncs.h"
+#include "scene/2d/collision_shape_2d.h"
+#include "scene/main/canvas_layer.h"
+#include "scene/main/scene_tree.h"
+#include "scene/main/viewport.h"
+#include "scene/resources/rectangle_shape_2d.h"
+#include "../Profiling/AllocationCounter.h"
+#include "../TouchScreenUI/TouchButton.h"
+#include "../TouchScreenUI/TouchScreenJoystick.h"
+
+#define CUSTOM_STATE(m_index) ((unsigned short)(m_index) << 10)
+
+static const int jump_period = 60; // ticks between jumps
+static const real_t level_width = 4096;
+static const real_t spawn_spacing = 24;
+static const int allocation_warmup_ticks = jump_period * 2; // every pattern went through each of its transitions once
+static const int touch_period = 20; // ticks between touch stream cycles
+static const char* touch_action = "marthvon_benchmark_touch";
+
+void CharacterBenchmark2D::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_character_count", "count"), &CharacterBenchmark2D::set_character_count);
+	ClassDB::bind_method(D_METHOD("get_character_count"), &CharacterBenchmark2D::get_character_count);
+	ClassDB::bind_method(D_METHOD("set_tick_count", "count"), &CharacterBenchmark2D::set_tick_count);
+	ClassDB::bind_method(D_METHOD("get_tick_count"), &CharacterBenchmark2D::get_tick_count);
+	ClassDB::bind_method(D_METHOD("set_input_pattern", "pattern"), &CharacterBenchmark2D::set_input_pattern);
+	ClassDB::bind_method(D_METHOD("get_input_pattern"), &CharacterBenchmark2D::get_input_pattern);
+	ClassDB::bind_method(D_METHOD("set_grounded_movement_data", "data"), &CharacterBenchmark2D::set_grounded_movement_data);
+	ClassDB::bind_method(D_METHOD("get_grounded_movement_data"), &CharacterBenchmark2D::get_grounded_movement_data);
+	ClassDB::bind_method(D_METHOD("set_jumping_movement_data", "data"), &CharacterBenchmark2D::set_jumping_movement_data);
+	ClassDB::bind_method(D_METHOD("get_jumping_movement_data"), &CharacterBenchmark2D::get_jumping_movement_data);
+	ClassDB::bind_method(D_METHOD("set_max_jump_count", "count"), &CharacterBenchmark2D::set_max_jump_count);
+	ClassDB::bind_method(D_METHOD("get_max_jump_count"), &CharacterBenchmark2D::get_max_jump_count);
+	ClassDB::bind_method(D_METHOD("toggle_autostart", "autostart"), &CharacterBenchmark2D::toggle_autostart);
+	ClassDB::bind_method(D_METHOD("is_autostart"), &CharacterBenchmark2D::is_autostart);
+	ClassDB::bind_method(D_METHOD("toggle_quit_on_finish", "quit"), &CharacterBenchmark2D::toggle_quit_on_finish);
+	ClassDB::bind_method(D_METHOD("is_quit_on_finish"), &CharacterBenchmark2D::is_quit_on_finish);
+	ClassDB::bind_method(D_METHOD("toggle_check_allocations", "check"), &CharacterBenchmark2D::toggle_check_allocations);
+	ClassDB::bind_method(D_METHOD("is_check_allocations"), &CharacterBenchmark2D::is_check_allocations);
+	ClassDB::bind_method(D_METHOD("toggle_kinematic_characters", "kinematic"), &CharacterBenchmark2D::toggle_kinematic_characters);
+	ClassDB::bind_method(D_METHOD("is_kinematic_characters"), &CharacterBenchmark2D::is_kinematic_characters);
+	ClassDB::bind_method(D_METHOD("_end_character_ticks"), &CharacterBenchmark2D::_end_character_ticks);
+
+	ClassDB::bind_method(D_METHOD("start"), &CharacterBenchmark2D::start);
+	ClassDB::bind_method(D_METHOD("is_running"), &CharacterBenchmark2D::is_running);
+	ClassDB::bind_method(D_METHOD("get_report"), &CharacterBenchmark2D::get_report);
+	ClassDB::bind_static_method("CharacterBenchmark2D", D_METHOD("get_allocation_count"), &CharacterBenchmark2D::get_allocation_count);
+
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "character_count", PROPERTY_HINT_RANGE, "1,10000,1"), "set_character_count", "get_character_count");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "tick_count", PROPERTY_HINT_RANGE, "1,100000,1,or_greater"), "set_tick_count", "get_tick_count");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "input_pattern", PROPERTY_HINT_ENUM, "Run,Jump,Multi Jump,Custom,Mixed"), "set_input_pattern", "get_input_pattern");
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "grounded_movement_data", PROPERTY_HINT_RESOURCE_TYPE, "GroundedMovementData1D"), "set_grounded_movement_data", "get_grounded_movement_data");
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "jumping_movement_data", PROPERTY_HINT_RESOURCE_TYPE, "MovementData2D"), "set_jumping_movement_data", "get_jumping_movement_data");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_jump_count", PROPERTY_HINT_RANGE, "1,15,1"), "set_max_jump_count", "get_max_jump_count");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "autostart"), "toggle_autostart", "is_autostart");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "quit_on_finish"), "toggle_quit_on_finish", "is_quit_on_finish");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "check_allocations"), "toggle_check_allocations", "is_check_allocations");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "kinematic_characters"), "toggle_kinematic_characters", "is_kinematic_characters");
+
+	ADD_SIGNAL(MethodInfo("finished", PropertyInfo(Variant::DICTIONARY, "report")));
+
+	BIND_ENUM_CONSTANT(PATTERN_RUN);
+	BIND_ENUM_CONSTANT(PATTERN_JUMP);
+	BIND_ENUM_CONSTANT(PATTERN_MULTI_JUMP);
+	BIND_ENUM_CONSTANT(PATTERN_CUSTOM);
+	BIND_ENUM_CONSTANT(PATTERN_MIXED);
+}
+
+void CharacterBenchmark2D::_notification(int p_notification) {
+	switch (p_notification) {
+		case NOTIFICATION_READY:
+			if (autostart && !Engine::get_singleton()->is_editor_hint())
+				start();
+		break;
+		// this node is processed before its descendant characters, so every tick first moves them the way a controller
+		// script would with the velocity their previous tick set, then writes the input their coming tick reads
+		case NOTIFICATION_PHYSICS_PROCESS: {
+			if (tick < 0)
+				break;
+			if (tick == 0) { // spawning is not part of the measurement
+				begin_usec = OS::get_singleton()->get_ticks_usec();
+				begin_allocations = get_allocation_count();
+			} else {
+				for (uint32_t i = 0; i < characters.size(); ++i)
+					characters[i]->move_character();
+			}
+			if (tick == tick_count) {
+				_finish();
+				break;
+			}
+			++tick;
+			_set_inputs();
+			if (check_allocations) {
+				_feed_touches();
+				// the characters tick after this node, deferred calls run once every physics process of the frame did
+				tick_window_begin = get_allocation_count();
+				call_deferred(SNAME("_end_character_ticks"));
+			}
+		} break;
+		case NOTIFICATION_EXIT_TREE:
+			_clear();
+		break;
+	};
+}
+
+void CharacterBenchmark2D::_spawn() {
+	Ref<GroundedMovementData1D> grounded = grounded_movement_data;
+	if (grounded.is_null()) {
+		grounded.instantiate();
+		grounded->set_speed(160);
+		grounded->set_acceleration(480);
+		grounded->set_max_speed(320);
+		grounded->set_min_speed(-320);
+	}
+	Ref<MovementData2D> jumping = jumping_movement_data;
+	if (jumping.is_null()) {
+		jumping.instantiate();
+		jumping->set_speed(160);
+		jumping->set_max_speed(320);
+		jumping->set_min_speed(-320);
+		jumping->set_jump_height(96);
+		jumping->set_jump_duration(0.4);
+	}
+	// index 0 is never read as a movement state, every index shares the profile
+	Array grounded_list;
+	grounded_list.resize(2);
+	grounded_list.fill(grounded);
+	Array jumping_list;
+	jumping_list.resize(max_jump_count + 1);
+	jumping_list.fill(jumping);
+	Ref<MovementSet> movement_set; // one set for every character
+	movement_set.instantiate();
+	movement_set->build(grounded_list, jumping_list);
+
+	level = memnew(Node2D);
+	add_child(level);
+	StaticBody2D* ground = memnew(StaticBody2D);
+	level->add_child(ground);
+	Ref<RectangleShape2D> floor_shape;
+	floor_shape.instantiate();
+	floor_shape->set_size(Vector2(level_width, 64));
+	CollisionShape2D* floor = memnew(CollisionShape2D);
+	floor->set_shape(floor_shape);
+	floor->set_position(Vector2(level_width * 0.5, 32));
+	ground->add_child(floor);
+	Ref<RectangleShape2D> platform_shape;
+	platform_shape.instantiate();
+	platform_shape->set_size(Vector2(128, 16));
+	// the same level as solid cells, for characters moving without bodies
+	Ref<TileOccupancyGrid2D> grid;
+	if (kinematic_characters) {
+		grid.instantiate();
+		grid->setup(Vector2(0, -256), Vector2(16, 16), Rect2i(0, 0, level_width / 16, 20));
+		grid->fill_rect(Rect2(0, 0, level_width, 64), true);
+	}
+	for (int i = 0; i < level_width / 256; ++i) { // platforms within jumping height, so jumps land on different heights
+		CollisionShape2D* platform = memnew(CollisionShape2D);
+		platform->set_shape(platform_shape);
+		platform->set_position(Vector2(128 + (i * 256), -64 - ((i % 3) * 24)));
+		ground->add_child(platform);
+		if (grid.is_valid())
+			grid->fill_rect(Rect2(platform->get_position() - platform_shape->get_size() * 0.5, platform_shape->get_size()), true);
+	}
+
+	Ref<RectangleShape2D> body_shape;
+	body_shape.instantiate();
+	body_shape->set_size(Vector2(16, 32));
+	const int columns = level_width / spawn_spacing;
+	characters.resize(character_count);
+	for (int i = 0; i < character_count; ++i) {
+		Character2DSideScroller* character = memnew(Character2DSideScroller);
+		character->set_movement_set(movement_set);
+		character->set_max_jump_count(max_jump_count);
+		// characters only collide with the level, thousands of them overlapping each other measures the broadphase
+		character->set_collision_layer(2);
+		character->set_collision_mask(1);
+		character->set_position(Vector2((i % columns) * spawn_spacing + spawn_spacing * 0.5, -16 - ((i / columns) * 40)));
+		CollisionShape2D* shape = memnew(CollisionShape2D);
+		shape->set_shape(body_shape);
+		character->add_child(shape);
+		if (grid.is_valid())
+			character->set_kinematic_grid(grid);
+		level->add_child(character);
+		characters[i] = character;
+	}
+	if (check_allocations)
+		_spawn_touch_controls();
+}
+
+void CharacterBenchmark2D::_spawn_touch_controls() {
+	if (!InputMap::get_singleton()->has_action(touch_action))
+		InputMap::get_singleton()->add_action(touch_action);
+	CanvasLayer* hud = memnew(CanvasLayer);
+	level->add_child(hud);
+	// the controls read input(), ignoring the mouse keeps the gui from copying every touch landing on them
+	touch_button = memnew(TouchButton);
+	touch_button->set_mouse_filter(Control::MOUSE_FILTER_IGNORE);
+	touch_button->set_action(touch_action);
+	touch_button->set_position(Vector2(900, 400));
+	touch_button->set_size(Vector2(120, 120));
+	hud->add_child(touch_button);
+	touch_button->set_process_input(true); // the button only turns its input on when its visibility changes
+	touch_joystick = memnew(TouchScreenJoystick);
+	touch_joystick->set_mouse_filter(Control::MOUSE_FILTER_IGNORE);
+	touch_joystick->set_position(Vector2(100, 360));
+	touch_joystick->set_size(Vector2(200, 200));
+	touch_joystick->toggle_monitor_speed(true);
+	hud->add_child(touch_joystick);
+	if (touch_event.is_null()) {
+		touch_event.instantiate();
+		drag_event.instantiate();
+	}
+}
+
+void CharacterBenchmark2D::_clear() {
+	characters.clear();
+	if (level) {
+		level->queue_free();
+		level = nullptr;
+	}
+	touch_button = nullptr;
+	touch_joystick = nullptr;
+	tick_window_begin = -1;
+	tick = -1;
+}
+
+// Writes the state a controller script would set before the next tick.
+void CharacterBenchmark2D::_set_inputs() {
+	for (uint32_t i = 0; i < characters.size(); ++i) {
+		Character2DSideScroller* character = characters[i];
+		const InputPattern pattern = (input_pattern == InputPattern::PATTERN_MIXED ? InputPattern(i % InputPattern::PATTERN_MIXED) : input_pattern);
+		const int phase = (tick + i) % jump_period;
+		const bool on_floor = character->is_character_on_floor(); // kinematic characters never update is_on_floor
+		unsigned short state = (unsigned short)(Character2DSideScroller::State::STATE_RUNNING) | CUSTOM_STATE(1);
+		switch (pattern) {
+			case InputPattern::PATTERN_RUN:
+				break;
+			case InputPattern::PATTERN_MULTI_JUMP:
+				if (!on_floor && phase == jump_period / 3 && max_jump_count > 1) {
+					state = (unsigned short)(Character2DSideScroller::State::STATE_IDLE) | (2 << 5);
+					break;
+				}
+				[[fallthrough]];
+			case InputPattern::PATTERN_JUMP:
+				if (on_floor && !phase)
+					state = (unsigned short)(Character2DSideScroller::State::STATE_RUNNING) | (unsigned short)(Character2DSideScroller::State::STATE_FALLING);
+				else if (!on_floor)
+					state = (unsigned short)(Character2DSideScroller::State::STATE_FALLING) | CUSTOM_STATE(1);
+				break;
+			case InputPattern::PATTERN_CUSTOM:
+				state = (phase ? CUSTOM_STATE(2) :
+					(unsigned short)(Character2DSideScroller::State::STATE_RUNNING) | (unsigned short)(Character2DSideScroller::State::REVERSE_TRANSITION_BIT_FLAG));
+				break;
+			default:
+				break;
+		}
+		character->toggle_facing_right((tick / (jump_period * 4)) % 2 == 0);
+		character->set_state(state);
+	}
+}
+
+// Presses and releases the button and drags the joystick around its center once every touch_period ticks.
+void CharacterBenchmark2D::_feed_touches() {
+	if (!touch_button || !touch_joystick)
+		return;
+	const int phase = tick % touch_period;
+	if (phase == 0 || phase == touch_period / 2) {
+		touch_event->set_index(0);
+		touch_event->set_position(touch_button->get_global_rect().get_center());
+		touch_event->set_pressed(phase == 0);
+		_push_touch(touch_event);
+	}
+	const Point2 stick_center = touch_joystick->get_global_rect().get_center();
+	if (phase == 0) {
+		touch_event->set_index(1);
+		touch_event->set_position(stick_center);
+		touch_event->set_pressed(true);
+		drag_event->set_position(stick_center);
+		_push_touch(touch_event);
+	} else if (phase < touch_period - 1) {
+		const real_t theta = Math_TAU * phase / touch_period;
+		const Point2 position = stick_center + Vector2(Math::cos(theta), Math::sin(theta)) * touch_joystick->get_size().x * 0.35;
+		drag_event->set_index(1);
+		drag_event->set_relative(position - drag_event->get_position());
+		drag_event->set_position(position);
+		_push_touch(drag_event);
+	} else {
+		touch_event->set_index(1);
+		touch_event->set_position(drag_event->get_position());
+		touch_event->set_pressed(false);
+		_push_touch(touch_event);
+	}
+}
+
+void CharacterBenchmark2D::_push_touch(const Ref<InputEvent>& p_event) {
+	const int64_t begin = get_allocation_count();
+	get_viewport()->push_input(p_event, true);
+	if (tick > allocation_warmup_ticks) {
+		steady_touch_allocations += get_allocation_count() - begin;
+		++steady_touch_events;
+	}
+}
+
+void CharacterBenchmark2D::_end_character_ticks() {
+	if (tick_window_begin < 0)
+		return;
+	if (tick > allocation_warmup_ticks) {
+		steady_tick_allocations += get_allocation_count() - tick_window_begin;
+		++steady_ticks;
+	}
+	tick_window_begin = -1;
+}
+
+void CharacterBenchmark2D::_finish() {
+	const uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin_usec, (uint64_t)1);
+	const int64_t allocations = get_allocation_count();
+
+	uint32_t checksum = HASH_MURMUR3_SEED;
+	for (uint32_t i = 0; i < characters.size(); ++i) {
+		const Vector2 position = characters[i]->get_position();
+		const Vector2 velocity = characters[i]->get_velocity();
+		checksum = hash_murmur3_one_real(position.x, checksum);
+		checksum = hash_murmur3_one_real(position.y, checksum);
+		checksum = hash_murmur3_one_real(velocity.x, checksum);
+		checksum = hash_murmur3_one_real(velocity.y, checksum);
+		checksum = hash_murmur3_one_32(characters[i]->get_state(), checksum);
+	}
+	checksum = hash_fmix32(checksum);
+
+	report = Dictionary(); // a report handed out before stays as it was
+	report["characters"] = character_count;
+	report["ticks"] = tick_count;
+	report["usec"] = elapsed;
+	report["ticks_per_second"] = tick_count * 1000000.0 / elapsed;
+	report["usec_per_tick"] = double(elapsed) / tick_count;
+	report["usec_per_character_tick"] = double(elapsed) / tick_count / character_count;
+	report["allocations_per_tick"] = (allocations < 0 ? -1.0 : double(allocations - begin_allocations) / tick_count);
+	report["checksum"] = checksum;
+	print_line(vformat("CharacterBenchmark2D: %d characters, %d ticks, %.1f ticks/s, %.3f usec/character tick, %.1f allocations/tick, checksum %08x",
+		character_count, tick_count, double(report["ticks_per_second"]), double(report["usec_per_character_tick"]), double(report["allocations_per_tick"]), checksum));
+
+	bool passed = true;
+	if (check_allocations) {
+		if (allocations < 0)
+			WARN_PRINT("CharacterBenchmark2D: allocations can't be counted on this platform, the allocation check is skipped.");
+		else if (!steady_ticks)
+			WARN_PRINT(vformat("CharacterBenchmark2D: the allocation check needs more than %d ticks, it is skipped.", allocation_warmup_ticks));
+		else {
+			passed = !steady_tick_allocations && !steady_touch_allocations;
+			report["steady_allocations_per_tick"] = double(steady_tick_allocations) / steady_ticks;
+			report["steady_allocations_per_touch_event"] = (steady_touch_events ? double(steady_touch_allocations) / steady_touch_events : 0.0);
+			report["allocation_check_passed"] = passed;
+			if (!passed)
+				ERR_PRINT(vformat("CharacterBenchmark2D: %d allocations over %d steady ticks and %d over %d touch events, none were expected.",
+					(int64_t)steady_tick_allocations, steady_ticks, (int64_t)steady_touch_allocations, steady_touch_events));
+		}
+	}
+
+	_clear();
+	set_physics_process(false);
+	emit_signal(SNAME("finished"), report);
+	if (quit_on_finish && is_inside_tree())
+		get_tree()->quit(passed ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+void CharacterBenchmark2D::start() {
+	ERR_FAIL_COND_MSG(!is_inside_tree(), "The benchmark needs to be inside the tree to step physics.");
+	_clear();
+	steady_tick_allocations = 0;
+	steady_touch_allocations = 0;
+	steady_ticks = 0;
+	steady_touch_events = 0;
+	_spawn();
+	tick = 0;
+	set_physics_process(true);
+}
+bool CharacterBenchmark2D::is_running() const {
+	return tick >= 0;
+}
+Dictionary CharacterBenchmark2D::get_report() const {
+	return report;
+}
+
+int64_t CharacterBenchmark2D::get_allocation_count() {
+	return AllocationCounter::get_count();
+}
+
+void CharacterBenchmark2D::set_character_count(const int p_count) {
+	ERR_FAIL_COND(p_count < 1);
+	character_count = p_count;
+}
+int CharacterBenchmark2D::get_character_count() const {
+	return character_count;
+}
+void CharacterBenchmark2D::set_tick_count(const int p_count) {
+	ERR_FAIL_COND(p_count < 1);
+	tick_count = p_count;
+}
+int CharacterBenchmark2D::get_tick_count() const {
+	return tick_count;
+}
+void CharacterBenchmark2D::set_input_pattern(const InputPattern p_pattern) {
+	ERR_FAIL_INDEX(p_pattern, InputPattern::PATTERN_MIXED + 1);
+	input_pattern = p_pattern;
+}
+CharacterBenchmark2D::InputPattern CharacterBenchmark2D::get_input_pattern() const {
+	return input_pattern;
+}
+void CharacterBenchmark2D::set_grounded_movement_data(const Ref<GroundedMovementData1D>& p_data) {
+	grounded_movement_data = p_data;
+}
+Ref<GroundedMovementData1D> CharacterBenchmark2D::get_grounded_movement_data() const {
+	return grounded_movement_data;
+}
+void CharacterBenchmark2D::set_jumping_movement_data(const Ref<MovementData2D>& p_data) {
+	jumping_movement_data = p_data;
+}
+Ref<MovementData2D> CharacterBenchmark2D::get_jumping_movement_data() const {
+	return jumping_movement_data;
+}
+void CharacterBenchmark2D::set_max_jump_count(const int p_count) {
+	ERR_FAIL_COND(p_count < 1 || p_count > 15);
+	max_jump_count = p_count;
+}
+int CharacterBenchmark2D::get_max_jump_count() const {
+	return max_jump_count;
+}
+void CharacterBenchmark2D::toggle_autostart(const bool p_autostart) {
+	autostart = p_autostart;
+}
+bool CharacterBenchmark2D::is_autostart() const {
+	return autostart;
+}
+void CharacterBenchmark2D::toggle_quit_on_finish(const bool p_quit) {
+	quit_on_finish = p_quit;
+}
+bool CharacterBenchmark2D::is_quit_on_finish() const {
+	return quit_on_finish;
+}
+void CharacterBenchmark2D::toggle_check_allocations(const bool p_check) {
+	check_allocations = p_check;
+}
+bool CharacterBenchmark2D::is_check_allocations() const {
+	return check_allocations;
+}
+void CharacterBenchmark2D::toggle_kinematic_characters(const bool p_kinematic) {
+	kinematic_characters = p_kinematic;
+}
+bool CharacterBenchmark2D::is_kinematic_characters() const {
+	return kinematic_characters;
+}
+
+#endif
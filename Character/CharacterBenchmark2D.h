@@ -0,0 +1,104 @@
+#ifndef CHARACTER_BENCHMARK_2D
+#define CHARACTER_BENCHMARK_2D
+
+#ifdef MARTHVON_BENCHMARK
+
+#include "scene/2d/node_2d.h"
+#include "core/input/input_event.h"
+#include "core/templates/local_vector.h"
+#include "Character2DSideScroller.h"
+
+class TouchButton;
+class TouchScreenJoystick;
+
+// Spawns characters on a synthetic level and times them over a fixed number of physics ticks.
+// Run a scene holding it with --headless --fixed-fps 60 so ticks are stepped as fast as possible.
+// With check_allocations, touch controls get a scripted touch stream and the run fails when a steady tick or event allocates.
+// tests/test_character_allocations.h runs it and asserts the same.
+class CharacterBenchmark2D : public Node2D {
+	GDCLASS(CharacterBenchmark2D, Node2D);
+
+public:
+	enum InputPattern {
+		PATTERN_RUN,
+		PATTERN_JUMP,
+		PATTERN_MULTI_JUMP,
+		PATTERN_CUSTOM,
+		PATTERN_MIXED // character i uses pattern i % PATTERN_MIXED
+	};
+
+private:
+	int character_count = 100;
+	int tick_count = 600;
+	InputPattern input_pattern = InputPattern::PATTERN_MIXED;
+	Ref<GroundedMovementData1D> grounded_movement_data;
+	Ref<MovementData2D> jumping_movement_data;
+	int max_jump_count = 2;
+	bool autostart = true;
+	bool quit_on_finish = true;
+	bool check_allocations = false;
+	bool kinematic_characters = false;
+
+	LocalVector<Character2DSideScroller*> characters;
+	Node2D* level = nullptr;
+	int tick = -1; // -1 while not running
+	uint64_t begin_usec = 0;
+	uint64_t begin_allocations = 0;
+
+	TouchButton* touch_button = nullptr;
+	TouchScreenJoystick* touch_joystick = nullptr;
+	Ref<InputEventScreenTouch> touch_event; // reused for every event of the stream
+	Ref<InputEventScreenDrag> drag_event;
+	int64_t tick_window_begin = -1; // allocation count when the characters' ticks of this frame started
+	uint64_t steady_tick_allocations = 0;
+	uint64_t steady_touch_allocations = 0;
+	int steady_ticks = 0;
+	int steady_touch_events = 0;
+	Dictionary report; // of the last finished run
+
+	void _spawn();
+	void _spawn_touch_controls();
+	void _clear();
+	void _set_inputs();
+	void _feed_touches();
+	void _push_touch(const Ref<InputEvent>& p_event);
+	void _end_character_ticks();
+	void _finish();
+
+protected:
+	void _notification(int p_notification);
+	static void _bind_methods();
+public:
+	void set_character_count(const int p_count);
+	int get_character_count() const;
+	void set_tick_count(const int p_count);
+	int get_tick_count() const;
+	void set_input_pattern(const InputPattern p_pattern);
+	InputPattern get_input_pattern() const;
+	void set_grounded_movement_data(const Ref<GroundedMovementData1D>& p_data);
+	Ref<GroundedMovementData1D> get_grounded_movement_data() const;
+	void set_jumping_movement_data(const Ref<MovementData2D>& p_data);
+	Ref<MovementData2D> get_jumping_movement_data() const;
+	void set_max_jump_count(const int p_count);
+	int get_max_jump_count() const;
+	void toggle_autostart(const bool p_autostart);
+	bool is_autostart() const;
+	void toggle_quit_on_finish(const bool p_quit);
+	bool is_quit_on_finish() const;
+	void toggle_check_allocations(const bool p_check);
+	bool is_check_allocations() const;
+	void toggle_kinematic_characters(const bool p_kinematic);
+	bool is_kinematic_characters() const;
+
+	void start();
+	bool is_running() const;
+	Dictionary get_report() const;
+
+	static int64_t get_allocation_count(); // main thread and character tasks, -1 when allocations can't be counted on this platform
+};
+
+VARIANT_ENUM_CAST(CharacterBenchmark2D::InputPattern);
+
+#endif
+
+#endif
@@ -0,0 +1,119 @@
+#include "CharacterPool2D.h"
+
+#include "core/config/engine.h"
+
+void CharacterPool2D::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_scene", "scene"), &CharacterPool2D::set_scene);
+	ClassDB::bind_method(D_METHOD("get_scene"), &CharacterPool2D::get_scene);
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "scene", PROPERTY_HINT_RESOURCE_TYPE, "PackedScene"), "set_scene", "get_scene");
+
+	ClassDB::bind_method(D_METHOD("set_size", "size"), &CharacterPool2D::set_size);
+	ClassDB::bind_method(D_METHOD("get_size"), &CharacterPool2D::get_size);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "size", PROPERTY_HINT_RANGE, "0,1024,1,or_greater"), "set_size", "get_size");
+
+	ClassDB::bind_method(D_METHOD("toggle_growable", "growable"), &CharacterPool2D::toggle_growable);
+	ClassDB::bind_method(D_METHOD("is_growable"), &CharacterPool2D::is_growable);
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "growable"), "toggle_growable", "is_growable");
+
+	ClassDB::bind_method(D_METHOD("acquire", "position", "facing_right"), &CharacterPool2D::acquire, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("release", "character"), &CharacterPool2D::release);
+	ClassDB::bind_method(D_METHOD("get_available_count"), &CharacterPool2D::get_available_count);
+	ClassDB::bind_method(D_METHOD("get_active_count"), &CharacterPool2D::get_active_count);
+}
+
+void CharacterPool2D::_notification(int p_notification) {
+	switch (p_notification) {
+		case NOTIFICATION_READY:
+			if (!Engine::get_singleton()->is_editor_hint())
+				_prewarm();
+		break;
+	};
+}
+
+Character2DSideScroller* CharacterPool2D::_instantiate() {
+	ERR_FAIL_COND_V_MSG(scene.is_null(), nullptr, "CharacterPool2D needs a scene to instance.");
+	Node* node = scene->instantiate();
+	Character2DSideScroller* character = Object::cast_to<Character2DSideScroller>(node);
+	if (!character) {
+		if (node)
+			memdelete(node);
+		ERR_FAIL_V_MSG(nullptr, "The root of the scene of a CharacterPool2D has to be a Character2DSideScroller.");
+	}
+	character->set_disable_mode(CollisionObject2D::DISABLE_MODE_REMOVE);
+	add_child(character);
+	++total;
+	return character;
+}
+
+void CharacterPool2D::_park(Character2DSideScroller* p_character) {
+	p_character->set_process_mode(PROCESS_MODE_DISABLED);
+	p_character->hide();
+}
+
+// the frame the pool becomes ready pays for every instance
+void CharacterPool2D::_prewarm() {
+	while (total < size) {
+		Character2DSideScroller* character = _instantiate();
+		if (!character)
+			return;
+		_park(character);
+		available.push_back(character->get_instance_id());
+	}
+}
+
+Character2DSideScroller* CharacterPool2D::acquire(const Vector2 p_position, const bool p_facing_right) {
+	Character2DSideScroller* character = nullptr;
+	while (!character && !available.is_empty()) {
+		character = Object::cast_to<Character2DSideScroller>(ObjectDB::get_instance(available[available.size() - 1]));
+		available.resize(available.size() - 1);
+		if (!character)
+			--total;
+	}
+	if (!character) {
+		ERR_FAIL_COND_V_MSG(!growable, nullptr, "The CharacterPool2D is empty, raise its size or make it growable.");
+		character = _instantiate();
+		ERR_FAIL_NULL_V(character, nullptr);
+	}
+	// reset while still disabled, the body enters the space again at the new position
+	character->reset_character(p_position, p_facing_right);
+	character->set_process_mode(PROCESS_MODE_INHERIT);
+	character->show();
+	return character;
+}
+
+void CharacterPool2D::release(Character2DSideScroller* p_character) {
+	ERR_FAIL_NULL(p_character);
+	ERR_FAIL_COND_MSG(p_character->get_parent() != this, "The character wasn't acquired from this pool.");
+	ERR_FAIL_COND_MSG(p_character->get_process_mode() == PROCESS_MODE_DISABLED, "The character was already released.");
+	_park(p_character);
+	available.push_back(p_character->get_instance_id());
+}
+
+int CharacterPool2D::get_available_count() const {
+	return available.size();
+}
+int CharacterPool2D::get_active_count() const {
+	return total - available.size();
+}
+
+void CharacterPool2D::set_scene(const Ref<PackedScene>& p_scene) {
+	scene = p_scene;
+}
+Ref<PackedScene> CharacterPool2D::get_scene() const {
+	return scene;
+}
+void CharacterPool2D::set_size(const int p_size) {
+	ERR_FAIL_COND(p_size < 0);
+	size = p_size;
+	if (is_inside_tree() && !Engine::get_singleton()->is_editor_hint())
+		_prewarm();
+}
+int CharacterPool2D::get_size() const {
+	return size;
+}
+void CharacterPool2D::toggle_growable(const bool p_growable) {
+	growable = p_growable;
+}
+bool CharacterPool2D::is_growable() const {
+	return growable;
+}
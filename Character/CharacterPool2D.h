@@ -0,0 +1,43 @@
+#ifndef CHARACTER_POOL_2D
+#define CHARACTER_POOL_2D
+
+#include "scene/main/node.h"
+#include "scene/resources/packed_scene.h"
+#include "core/templates/local_vector.h"
+#include "Character2DSideScroller.h"
+
+// Instances a character scene ahead of time and hands the characters out again instead of instancing and freeing.
+// Parked characters are disabled and hidden, which takes their bodies out of the physics space.
+class CharacterPool2D : public Node {
+	GDCLASS(CharacterPool2D, Node);
+
+	Ref<PackedScene> scene;
+	int size = 16;
+	bool growable = false;
+
+	LocalVector<ObjectID> available; // parked characters, a character freed by someone else is skipped
+	int total = 0;
+
+	Character2DSideScroller* _instantiate();
+	void _park(Character2DSideScroller* p_character);
+	void _prewarm();
+
+protected:
+	void _notification(int p_notification);
+	static void _bind_methods();
+public:
+	void set_scene(const Ref<PackedScene>& p_scene);
+	Ref<PackedScene> get_scene() const;
+	void set_size(const int p_size);
+	int get_size() const;
+	void toggle_growable(const bool p_growable);
+	bool is_growable() const;
+
+	Character2DSideScroller* acquire(const Vector2 p_position, const bool p_facing_right);
+	void release(Character2DSideScroller* p_character);
+
+	int get_available_count() const;
+	int get_active_count() const;
+};
+
+#endif
@@ -0,0 +1,301 @@
+#include "Controller.h"
+
+#include "core/config/engine.h"
+#include "../TouchScreenUI/TouchInputQueue.h"
+
+void ControllerMapping2D::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_direction_state", "direction", "state"), &ControllerMapping2D::set_direction_state);
+	ClassDB::bind_method(D_METHOD("get_direction_state", "direction"), &ControllerMapping2D::get_direction_state);
+
+	ClassDB::bind_method(D_METHOD("set_button_press_states", "states"), &ControllerMapping2D::set_button_press_states);
+	ClassDB::bind_method(D_METHOD("get_button_press_states"), &ControllerMapping2D::get_button_press_states);
+	ClassDB::bind_method(D_METHOD("set_button_held_states", "states"), &ControllerMapping2D::set_button_held_states);
+	ClassDB::bind_method(D_METHOD("get_button_held_states"), &ControllerMapping2D::get_button_held_states);
+
+	ClassDB::bind_method(D_METHOD("toggle_face_direction", "face"), &ControllerMapping2D::toggle_face_direction);
+	ClassDB::bind_method(D_METHOD("is_face_direction"), &ControllerMapping2D::is_face_direction);
+	ClassDB::bind_method(D_METHOD("set_walk_threshold", "threshold"), &ControllerMapping2D::set_walk_threshold);
+	ClassDB::bind_method(D_METHOD("get_walk_threshold"), &ControllerMapping2D::get_walk_threshold);
+	ClassDB::bind_method(D_METHOD("set_walk_state", "state"), &ControllerMapping2D::set_walk_state);
+	ClassDB::bind_method(D_METHOD("get_walk_state"), &ControllerMapping2D::get_walk_state);
+
+	ADD_GROUP("Direction States", "direction_");
+	ADD_PROPERTYI(PropertyInfo(Variant::INT, "direction_neutral"), "set_direction_state", "get_direction_state", TouchScreenPad::DIR_NEUTRAL);
+	ADD_PROPERTYI(PropertyInfo(Variant::INT, "direction_left"), "set_direction_state", "get_direction_state", TouchScreenPad::DIR_LEFT);
+	ADD_PROPERTYI(PropertyInfo(Variant::INT, "direction_right"), "set_direction_state", "get_direction_state", TouchScreenPad::DIR_RIGHT);
+	ADD_PROPERTYI(PropertyInfo(Variant::INT, "direction_down"), "set_direction_state", "get_direction_state", TouchScreenPad::DIR_DOWN);
+	ADD_PROPERTYI(PropertyInfo(Variant::INT, "direction_down_left"), "set_direction_state", "get_direction_state", TouchScreenPad::DIR_DOWN_LEFT);
+	ADD_PROPERTYI(PropertyInfo(Variant::INT, "direction_down_right"), "set_direction_state", "get_direction_state", TouchScreenPad::DIR_DOWN_RIGHT);
+	ADD_PROPERTYI(PropertyInfo(Variant::INT, "direction_up"), "set_direction_state", "get_direction_state", TouchScreenPad::DIR_UP);
+	ADD_PROPERTYI(PropertyInfo(Variant::INT, "direction_up_left"), "set_direction_state", "get_direction_state", TouchScreenPad::DIR_UP_LEFT);
+	ADD_PROPERTYI(PropertyInfo(Variant::INT, "direction_up_right"), "set_direction_state", "get_direction_state", TouchScreenPad::DIR_UP_RIGHT);
+	ADD_GROUP("", "");
+
+	ADD_PROPERTY(PropertyInfo(Variant::PACKED_INT32_ARRAY, "button_press_states"), "set_button_press_states", "get_button_press_states");
+	ADD_PROPERTY(PropertyInfo(Variant::PACKED_INT32_ARRAY, "button_held_states"), "set_button_held_states", "get_button_held_states");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "face_direction"), "toggle_face_direction", "is_face_direction");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "walk_threshold", PROPERTY_HINT_RANGE, "0,1,0.01"), "set_walk_threshold", "get_walk_threshold");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "walk_state"), "set_walk_state", "get_walk_state");
+
+	BIND_CONSTANT(KEEP_STATE);
+}
+
+void ControllerMapping2D::set_direction_state(const TouchScreenPad::Direction p_direction, const int p_state) {
+	ERR_FAIL_INDEX(p_direction, DIRECTION_MAX);
+	ERR_FAIL_COND(p_state < KEEP_STATE || p_state > UINT16_MAX);
+	direction_states[p_direction] = p_state;
+	emit_changed();
+}
+int ControllerMapping2D::get_direction_state(const TouchScreenPad::Direction p_direction) const {
+	ERR_FAIL_INDEX_V(p_direction, DIRECTION_MAX, KEEP_STATE);
+	return direction_states[p_direction];
+}
+void ControllerMapping2D::set_button_press_states(const PackedInt32Array& p_states) {
+	button_press_states = p_states;
+	emit_changed();
+}
+PackedInt32Array ControllerMapping2D::get_button_press_states() const {
+	return button_press_states;
+}
+void ControllerMapping2D::set_button_held_states(const PackedInt32Array& p_states) {
+	button_held_states = p_states;
+	emit_changed();
+}
+PackedInt32Array ControllerMapping2D::get_button_held_states() const {
+	return button_held_states;
+}
+void ControllerMapping2D::toggle_face_direction(const bool p_face) {
+	face_direction = p_face;
+	emit_changed();
+}
+bool ControllerMapping2D::is_face_direction() const {
+	return face_direction;
+}
+void ControllerMapping2D::set_walk_threshold(const real_t p_threshold) {
+	walk_threshold = CLAMP(p_threshold, (real_t)0, (real_t)1);
+	emit_changed();
+}
+real_t ControllerMapping2D::get_walk_threshold() const {
+	return walk_threshold;
+}
+void ControllerMapping2D::set_walk_state(const int p_state) {
+	ERR_FAIL_COND(p_state < KEEP_STATE || p_state > UINT16_MAX);
+	walk_state = p_state;
+	emit_changed();
+}
+int ControllerMapping2D::get_walk_state() const {
+	return walk_state;
+}
+
+ControllerMapping2D::ControllerMapping2D() {
+	for (int i = 0; i < DIRECTION_MAX; ++i)
+		direction_states[i] = KEEP_STATE;
+	direction_states[TouchScreenPad::DIR_NEUTRAL] = (int)Character2DSideScroller::State::STATE_IDLE;
+	direction_states[TouchScreenPad::DIR_LEFT] = (int)Character2DSideScroller::State::STATE_RUNNING;
+	direction_states[TouchScreenPad::DIR_RIGHT] = (int)Character2DSideScroller::State::STATE_RUNNING;
+	direction_states[TouchScreenPad::DIR_DOWN] = (int)Character2DSideScroller::State::STATE_CRAWLING;
+	direction_states[TouchScreenPad::DIR_DOWN_LEFT] = (int)Character2DSideScroller::State::STATE_CRAWLING;
+	direction_states[TouchScreenPad::DIR_DOWN_RIGHT] = (int)Character2DSideScroller::State::STATE_CRAWLING;
+}
+
+void Controller2D::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_pad_path", "path"), &Controller2D::set_pad_path);
+	ClassDB::bind_method(D_METHOD("get_pad_path"), &Controller2D::get_pad_path);
+	ClassDB::bind_method(D_METHOD("set_character_path", "path"), &Controller2D::set_character_path);
+	ClassDB::bind_method(D_METHOD("get_character_path"), &Controller2D::get_character_path);
+	ClassDB::bind_method(D_METHOD("set_button_paths", "paths"), &Controller2D::set_button_paths);
+	ClassDB::bind_method(D_METHOD("get_button_paths"), &Controller2D::get_button_paths);
+	ClassDB::bind_method(D_METHOD("set_mapping", "mapping"), &Controller2D::set_mapping);
+	ClassDB::bind_method(D_METHOD("get_mapping"), &Controller2D::get_mapping);
+	ClassDB::bind_method(D_METHOD("set_stream_graph_path", "path"), &Controller2D::set_stream_graph_path);
+	ClassDB::bind_method(D_METHOD("get_stream_graph_path"), &Controller2D::get_stream_graph_path);
+
+	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "pad_path", PROPERTY_HINT_NODE_PATH_VALID_TYPES, "TouchScreenPad"), "set_pad_path", "get_pad_path");
+	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "character_path", PROPERTY_HINT_NODE_PATH_VALID_TYPES, "Character2DSideScroller"), "set_character_path", "get_character_path");
+	ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "button_paths", PROPERTY_HINT_ARRAY_TYPE, vformat("%s/%s:%s", Variant::NODE_PATH, PROPERTY_HINT_NODE_PATH_VALID_TYPES, "TouchButton")), "set_button_paths", "get_button_paths");
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "mapping", PROPERTY_HINT_RESOURCE_TYPE, "ControllerMapping2D"), "set_mapping", "get_mapping");
+	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "stream_graph_path", PROPERTY_HINT_NODE_PATH_VALID_TYPES, "StreamGraph"), "set_stream_graph_path", "get_stream_graph_path");
+}
+
+void Controller2D::_notification(int p_notification) {
+	switch (p_notification) {
+		case NOTIFICATION_READY:
+			_resolve_nodes();
+		break;
+		case NOTIFICATION_EXIT_TREE:
+			_leave_stream_graph();
+			request_ready(); // the nodes are resolved again on the next entry
+		break;
+		case NOTIFICATION_INTERNAL_PHYSICS_PROCESS:
+			_control();
+		break;
+	};
+}
+
+void Controller2D::_resolve_nodes() {
+	pad = ObjectID();
+	character = ObjectID();
+	buttons.clear();
+	held_buttons = 0;
+	last_state = ControllerMapping2D::KEEP_STATE;
+	_leave_stream_graph();
+	if (!is_inside_tree())
+		return;
+	TouchScreenPad* pad_node = Object::cast_to<TouchScreenPad>(get_node_or_null(pad_path));
+	if (pad_node)
+		pad = pad_node->get_instance_id();
+	StreamGraph* graph = Object::cast_to<StreamGraph>(get_node_or_null(stream_graph_path));
+	if (graph && pad_node) {
+		stream_graph = graph->get_instance_id();
+		plug_direction = pad_node->get_direction();
+		direction_input->connect_plug(pad_node->get_direction_plug());
+		graph->add_processor(this);
+	}
+	set_physics_process_internal(!Engine::get_singleton()->is_editor_hint() && stream_graph.is_null());
+	const Character2DSideScroller* character_node = Object::cast_to<Character2DSideScroller>(get_node_or_null(character_path));
+	if (character_node)
+		character = character_node->get_instance_id();
+	ERR_FAIL_COND_MSG(button_paths.size() > 32, "Controller2D supports up to 32 buttons.");
+	buttons.resize(button_paths.size());
+	for (int i = 0; i < button_paths.size(); ++i) {
+		const TouchButton* button = Object::cast_to<TouchButton>(get_node_or_null(button_paths[i]));
+		buttons[i] = (button ? button->get_instance_id() : ObjectID());
+	}
+}
+
+void Controller2D::_leave_stream_graph() {
+	StreamGraph* graph = Object::cast_to<StreamGraph>(ObjectDB::get_instance(stream_graph));
+	if (graph)
+		graph->remove_processor(this);
+	stream_graph = ObjectID();
+	direction_input->disconnect_plug();
+}
+
+void Controller2D::_evaluate_stream(const double delta) {
+	PlugSample sample;
+	while (direction_input->read_sample(sample))
+		plug_direction = sample.integer;
+	_control();
+}
+uint32_t Controller2D::_get_stream_input_count() const {
+	return 1;
+}
+InputPlug* Controller2D::_get_stream_input(const uint32_t p_index) const {
+	return p_index == 0 ? direction_input.ptr() : nullptr;
+}
+
+void Controller2D::_control() {
+	Character2DSideScroller* character_node = Object::cast_to<Character2DSideScroller>(ObjectDB::get_instance(character));
+	if (!character_node || mapping.is_null())
+		return;
+	const ControllerMapping2D* map = *mapping;
+
+	int state = ControllerMapping2D::KEEP_STATE;
+	const TouchScreenPad* pad_node = Object::cast_to<TouchScreenPad>(ObjectDB::get_instance(pad));
+	if (pad_node) {
+		const TouchScreenPad::Direction direction = (stream_graph.is_valid() ? (TouchScreenPad::Direction)plug_direction : pad_node->get_direction());
+		state = map->_get_direction_state(direction);
+		// the stick decides how fast, the direction only which way
+		if (direction != TouchScreenPad::DIR_NEUTRAL && state != ControllerMapping2D::KEEP_STATE && map->get_walk_state() != ControllerMapping2D::KEEP_STATE &&
+				pad_node->get_vector().length() < map->get_walk_threshold())
+			state = map->get_walk_state();
+		if (map->is_face_direction() && (direction & (TouchScreenPad::DIR_LEFT | TouchScreenPad::DIR_RIGHT)))
+			character_node->toggle_facing_right(direction & TouchScreenPad::DIR_RIGHT);
+	}
+
+	// a tap shorter than a tick left no finger on the button, the queue still holds its press
+	const uint32_t queued = _get_queued_presses();
+	uint32_t held = 0;
+	int press_state = ControllerMapping2D::KEEP_STATE;
+	for (uint32_t i = 0; i < buttons.size(); ++i) {
+		const TouchButton* button = Object::cast_to<TouchButton>(ObjectDB::get_instance(buttons[i]));
+		if (!button || (button->get_finger_index() == -1 && !(queued & (1u << i))))
+			continue;
+		held |= (1u << i);
+		const int held_state = map->_get_button_held_state(i);
+		if (held_state != ControllerMapping2D::KEEP_STATE)
+			state = held_state;
+		if (!(held_buttons & (1u << i)) && press_state == ControllerMapping2D::KEEP_STATE)
+			press_state = map->_get_button_press_state(i);
+	}
+	held_buttons = held;
+
+	// a press is a one tick event, it is written even when the held input did not change
+	if (press_state != ControllerMapping2D::KEEP_STATE) {
+		character_node->set_state(press_state);
+		last_state = state;
+		return;
+	}
+	if (state == ControllerMapping2D::KEEP_STATE || state == last_state)
+		return;
+	last_state = state;
+	character_node->set_state(state);
+}
+
+uint32_t Controller2D::_get_queued_presses() const {
+	const TouchInputQueue* queue = TouchInputQueue::get_singleton();
+	if (!queue)
+		return 0;
+	uint32_t pressed = 0;
+	for (uint32_t t = 0; t < queue->get_transition_count(); ++t) {
+		const TouchInputTransition& transition = queue->get_transition(t);
+		if (transition.kind != TouchInputTransition::KIND_BUTTON || !transition.value)
+			continue;
+		for (uint32_t i = 0; i < buttons.size(); ++i) {
+			if (buttons[i] == transition.control)
+				pressed |= (1u << i);
+		}
+	}
+	return pressed;
+}
+
+void Controller2D::set_pad_path(const NodePath& p_path) {
+	pad_path = p_path;
+	if (is_inside_tree())
+		_resolve_nodes();
+}
+NodePath Controller2D::get_pad_path() const {
+	return pad_path;
+}
+void Controller2D::set_character_path(const NodePath& p_path) {
+	character_path = p_path;
+	if (is_inside_tree())
+		_resolve_nodes();
+}
+NodePath Controller2D::get_character_path() const {
+	return character_path;
+}
+void Controller2D::set_button_paths(const Array& p_paths) {
+	button_paths = p_paths;
+	if (is_inside_tree())
+		_resolve_nodes();
+}
+Array Controller2D::get_button_paths() const {
+	return button_paths;
+}
+void Controller2D::set_mapping(const Ref<ControllerMapping2D>& p_mapping) {
+	mapping = p_mapping;
+	last_state = ControllerMapping2D::KEEP_STATE;
+}
+Ref<ControllerMapping2D> Controller2D::get_mapping() const {
+	return mapping;
+}
+void Controller2D::set_stream_graph_path(const NodePath& p_path) {
+	stream_graph_path = p_path;
+	if (is_inside_tree())
+		_resolve_nodes();
+}
+NodePath Controller2D::get_stream_graph_path() const {
+	return stream_graph_path;
+}
+
+Controller2D::Controller2D() {
+	set_physics_process_priority(-1); // characters tick after their input is written
+	direction_input.instantiate();
+	direction_input->set_type(OutputPlug::TYPE_INT);
+	direction_input->set_processor(this);
+}
+
+Controller2D::~Controller2D() {
+	direction_input->set_processor(nullptr);
+}
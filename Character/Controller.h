@@ -0,0 +1,104 @@
+#ifndef CONTROLLER_2D
+#define CONTROLLER_2D
+
+#include "core/io/resource.h"
+#include "scene/main/node.h"
+#include "core/templates/local_vector.h"
+#include "Character2DSideScroller.h"
+#include "../TouchScreenUI/TouchScreenPad.h"
+#include "../TouchScreenUI/TouchButton.h"
+#include "../Bitwise/StreamGraph.h"
+
+// Which state a Controller2D writes for each pad direction and button.
+class ControllerMapping2D : public Resource {
+	GDCLASS(ControllerMapping2D, Resource);
+
+public:
+	enum {
+		KEEP_STATE = -1,
+		DIRECTION_MAX = TouchScreenPad::DIR_UP_RIGHT + 1
+	};
+
+private:
+	int direction_states[DIRECTION_MAX];
+	PackedInt32Array button_press_states; // written on the tick a button goes down
+	PackedInt32Array button_held_states; // written while a button is held, overrides the direction
+	bool face_direction = true;
+	real_t walk_threshold = 0; // a stick pushed less than this writes walk_state instead, 0 never walks
+	int walk_state = (int)Character2DSideScroller::State::STATE_WALKING;
+
+protected:
+	static void _bind_methods();
+public:
+	void set_direction_state(const TouchScreenPad::Direction p_direction, const int p_state);
+	int get_direction_state(const TouchScreenPad::Direction p_direction) const;
+
+	void set_button_press_states(const PackedInt32Array& p_states);
+	PackedInt32Array get_button_press_states() const;
+	void set_button_held_states(const PackedInt32Array& p_states);
+	PackedInt32Array get_button_held_states() const;
+
+	void toggle_face_direction(const bool p_face);
+	bool is_face_direction() const;
+	void set_walk_threshold(const real_t p_threshold);
+	real_t get_walk_threshold() const;
+	void set_walk_state(const int p_state);
+	int get_walk_state() const;
+
+	_FORCE_INLINE_ int _get_direction_state(const int p_direction) const { return direction_states[p_direction]; }
+	_FORCE_INLINE_ int _get_button_press_state(const int p_button) const { return p_button < button_press_states.size() ? button_press_states[p_button] : KEEP_STATE; }
+	_FORCE_INLINE_ int _get_button_held_state(const int p_button) const { return p_button < button_held_states.size() ? button_held_states[p_button] : KEEP_STATE; }
+
+	ControllerMapping2D();
+};
+
+// Pulls a touch pad and buttons once per physics tick and drives a character with them, before the character's own tick.
+// Inside a StreamGraph the pad direction is read from its plug and the graph ticks the controller.
+class Controller2D : public Node, public StreamProcessor {
+	GDCLASS(Controller2D, Node);
+
+	NodePath pad_path = NodePath();
+	NodePath stream_graph_path = NodePath();
+	NodePath character_path = NodePath();
+	Array button_paths;
+	Ref<ControllerMapping2D> mapping;
+
+	ObjectID pad;
+	ObjectID character;
+	ObjectID stream_graph;
+	Ref<InputPlug> direction_input; // connected to the direction plug of the pad while in a graph
+	int plug_direction = TouchScreenPad::DIR_NEUTRAL;
+	LocalVector<ObjectID> buttons;
+
+	uint32_t held_buttons = 0; // bit per button of the last tick
+	uint32_t _get_queued_presses() const; // buttons pressed since the last tick, a tap released before it included
+	int last_state = ControllerMapping2D::KEEP_STATE; // only changes of the input are written, the character's own transitions are left alone
+
+	void _resolve_nodes();
+	void _leave_stream_graph();
+	void _control();
+
+protected:
+	void _notification(int p_notification);
+	static void _bind_methods();
+public:
+	void set_pad_path(const NodePath& p_path);
+	NodePath get_pad_path() const;
+	void set_character_path(const NodePath& p_path);
+	NodePath get_character_path() const;
+	void set_button_paths(const Array& p_paths);
+	Array get_button_paths() const;
+	void set_mapping(const Ref<ControllerMapping2D>& p_mapping);
+	Ref<ControllerMapping2D> get_mapping() const;
+	void set_stream_graph_path(const NodePath& p_path);
+	NodePath get_stream_graph_path() const;
+
+	virtual void _evaluate_stream(const double delta) override;
+	virtual uint32_t _get_stream_input_count() const override;
+	virtual InputPlug* _get_stream_input(const uint32_t p_index) const override;
+
+	Controller2D();
+	~Controller2D();
+};
+
+#endif
@@ -0,0 +1,223 @@
+#include "GhostPlayer2D.h"
+
+#include "core/config/engine.h"
+#include "core/object/worker_thread_pool.h"
+
+static const uint32_t parallel_ghost_count = 32; // fewer ghosts decode faster than a group task starts
+
+void GhostPlayer2D::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_recordings", "recordings"), &GhostPlayer2D::set_recordings);
+	ClassDB::bind_method(D_METHOD("get_recordings"), &GhostPlayer2D::get_recordings);
+	ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "recordings", PROPERTY_HINT_ARRAY_TYPE, "GhostRecording"), "set_recordings", "get_recordings");
+
+	ClassDB::bind_method(D_METHOD("set_texture", "texture"), &GhostPlayer2D::set_texture);
+	ClassDB::bind_method(D_METHOD("get_texture"), &GhostPlayer2D::get_texture);
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "texture", PROPERTY_HINT_RESOURCE_TYPE, "Texture2D"), "set_texture", "get_texture");
+
+	ClassDB::bind_method(D_METHOD("set_ticks_per_second", "ticks"), &GhostPlayer2D::set_ticks_per_second);
+	ClassDB::bind_method(D_METHOD("get_ticks_per_second"), &GhostPlayer2D::get_ticks_per_second);
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "ticks_per_second", PROPERTY_HINT_RANGE, "0,240,1,or_greater"), "set_ticks_per_second", "get_ticks_per_second");
+
+	ClassDB::bind_method(D_METHOD("toggle_playing", "playing"), &GhostPlayer2D::toggle_playing);
+	ClassDB::bind_method(D_METHOD("is_playing"), &GhostPlayer2D::is_playing);
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "playing"), "toggle_playing", "is_playing");
+
+	ClassDB::bind_method(D_METHOD("toggle_loop", "loop"), &GhostPlayer2D::toggle_loop);
+	ClassDB::bind_method(D_METHOD("is_loop"), &GhostPlayer2D::is_loop);
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "loop"), "toggle_loop", "is_loop");
+
+	ClassDB::bind_method(D_METHOD("play"), &GhostPlayer2D::play);
+	ClassDB::bind_method(D_METHOD("stop"), &GhostPlayer2D::stop);
+	ClassDB::bind_method(D_METHOD("seek", "tick"), &GhostPlayer2D::seek);
+	ClassDB::bind_method(D_METHOD("get_time"), &GhostPlayer2D::get_time);
+
+	ClassDB::bind_method(D_METHOD("get_ghost_count"), &GhostPlayer2D::get_ghost_count);
+	ClassDB::bind_method(D_METHOD("get_ghost_position", "index"), &GhostPlayer2D::get_ghost_position);
+	ClassDB::bind_method(D_METHOD("get_ghost_state", "index"), &GhostPlayer2D::get_ghost_state);
+	ClassDB::bind_method(D_METHOD("is_ghost_facing_right", "index"), &GhostPlayer2D::is_ghost_facing_right);
+
+	ADD_SIGNAL(MethodInfo("finished"));
+}
+
+void GhostPlayer2D::_notification(int p_notification) {
+	switch (p_notification) {
+		case NOTIFICATION_READY:
+			if (!Engine::get_singleton()->is_editor_hint())
+				set_process_internal(playing);
+		break;
+		case NOTIFICATION_INTERNAL_PROCESS: {
+			const double rate = (ticks_per_second > 0 ? ticks_per_second : Engine::get_singleton()->get_physics_ticks_per_second());
+			time += get_process_delta_time() * rate;
+			const int length = _get_length();
+			if (time >= length - 1) {
+				if (loop && length > 1) {
+					time = Math::fmod(time, double(length - 1));
+					_rewind();
+				} else {
+					time = MAX(length - 1, 0);
+					_advance(length);
+					toggle_playing(false);
+					queue_redraw();
+					emit_signal(SNAME("finished"));
+					break;
+				}
+			}
+			_advance(int(time) + 1);
+			queue_redraw();
+		} break;
+		case NOTIFICATION_DRAW: {
+			if (texture.is_null())
+				break;
+			// recordings hold global positions
+			draw_set_transform_matrix(get_global_transform().affine_inverse());
+			const Size2 size = texture->get_size();
+			for (uint32_t i = 0; i < ghosts.size(); ++i) {
+				if (ghosts[i].tick < 0)
+					continue;
+				// a negative width flips the texture
+				draw_texture_rect(texture, Rect2(get_ghost_position(i) - size * 0.5, Size2(ghosts[i].current.facing_right ? size.x : -size.x, size.y)), false);
+			}
+		} break;
+	};
+}
+
+void GhostPlayer2D::_rebuild() {
+	ghosts.resize(recordings.size());
+	for (uint32_t i = 0; i < ghosts.size(); ++i) {
+		Ghost& ghost = ghosts[i];
+		ghost.recording = recordings[i];
+		ghost.reader.instantiate();
+		if (ghost.recording.is_valid())
+			ghost.reader->set_data(ghost.recording->get_data());
+	}
+	time = 0;
+	_rewind();
+	queue_redraw();
+}
+
+void GhostPlayer2D::_rewind() {
+	for (uint32_t i = 0; i < ghosts.size(); ++i) {
+		Ghost& ghost = ghosts[i];
+		ghost.reader->reset_read();
+		ghost.previous = GhostRecording::Frame();
+		ghost.current = GhostRecording::Frame();
+		ghost.tick = -1;
+		if (ghost.recording.is_null() || !ghost.recording->get_tick_count())
+			continue;
+		GhostRecording::read_frame(ghost.reader.ptr(), ghost.previous, ghost.current);
+		ghost.previous = ghost.current;
+		ghost.tick = 0;
+	}
+}
+
+void GhostPlayer2D::_advance(const int p_tick) {
+	if (ghosts.size() < parallel_ghost_count) {
+		for (uint32_t i = 0; i < ghosts.size(); ++i)
+			_advance_task(i, p_tick);
+		return;
+	}
+	WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GhostPlayer2D::_advance_task, p_tick, ghosts.size(), -1, true);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+}
+
+// decodes up to p_tick, a ghost past its last tick holds it
+void GhostPlayer2D::_advance_task(const uint32_t p_index, const int p_tick) {
+	Ghost& ghost = ghosts[p_index];
+	if (ghost.tick < 0)
+		return;
+	const int last = ghost.recording->get_tick_count() - 1;
+	for (const int tick = MIN(p_tick, last); ghost.tick < tick && !ghost.reader->is_read_overflow(); ++ghost.tick) {
+		ghost.previous = ghost.current;
+		GhostRecording::read_frame(ghost.reader.ptr(), ghost.previous, ghost.current);
+	}
+	if (p_tick > last)
+		ghost.previous = ghost.current;
+}
+
+int GhostPlayer2D::_get_length() const {
+	int length = 0;
+	for (uint32_t i = 0; i < ghosts.size(); ++i) {
+		if (ghosts[i].recording.is_valid())
+			length = MAX(length, ghosts[i].recording->get_tick_count());
+	}
+	return length;
+}
+
+void GhostPlayer2D::play() {
+	if (time >= _get_length() - 1) {
+		time = 0;
+		_rewind();
+	}
+	toggle_playing(true);
+}
+void GhostPlayer2D::stop() {
+	toggle_playing(false);
+	time = 0;
+	_rewind();
+	queue_redraw();
+}
+void GhostPlayer2D::seek(const double p_tick) {
+	time = CLAMP(p_tick, 0.0, double(MAX(_get_length() - 1, 0)));
+	_rewind();
+	_advance(int(time) + 1);
+	queue_redraw();
+}
+double GhostPlayer2D::get_time() const {
+	return time;
+}
+
+int GhostPlayer2D::get_ghost_count() const {
+	return ghosts.size();
+}
+Vector2 GhostPlayer2D::get_ghost_position(const int p_index) const {
+	ERR_FAIL_INDEX_V(p_index, (int)ghosts.size(), Vector2());
+	const Ghost& ghost = ghosts[p_index];
+	if (ghost.tick < 0)
+		return Vector2();
+	const real_t weight = CLAMP(time - (ghost.tick - 1), 0.0, 1.0);
+	return ghost.recording->to_position(ghost.previous.position).lerp(ghost.recording->to_position(ghost.current.position), weight);
+}
+int GhostPlayer2D::get_ghost_state(const int p_index) const {
+	ERR_FAIL_INDEX_V(p_index, (int)ghosts.size(), 0);
+	return ghosts[p_index].current.state;
+}
+bool GhostPlayer2D::is_ghost_facing_right(const int p_index) const {
+	ERR_FAIL_INDEX_V(p_index, (int)ghosts.size(), true);
+	return ghosts[p_index].current.facing_right;
+}
+
+void GhostPlayer2D::set_recordings(const TypedArray<GhostRecording>& p_recordings) {
+	recordings = p_recordings;
+	_rebuild();
+}
+TypedArray<GhostRecording> GhostPlayer2D::get_recordings() const {
+	return recordings;
+}
+void GhostPlayer2D::set_texture(const Ref<Texture2D>& p_texture) {
+	texture = p_texture;
+	queue_redraw();
+}
+Ref<Texture2D> GhostPlayer2D::get_texture() const {
+	return texture;
+}
+void GhostPlayer2D::set_ticks_per_second(const double p_ticks) {
+	ERR_FAIL_COND(p_ticks < 0);
+	ticks_per_second = p_ticks;
+}
+double GhostPlayer2D::get_ticks_per_second() const {
+	return ticks_per_second;
+}
+void GhostPlayer2D::toggle_playing(const bool p_playing) {
+	playing = p_playing;
+	if (is_inside_tree() && !Engine::get_singleton()->is_editor_hint())
+		set_process_internal(playing);
+}
+bool GhostPlayer2D::is_playing() const {
+	return playing;
+}
+void GhostPlayer2D::toggle_loop(const bool p_loop) {
+	loop = p_loop;
+}
+bool GhostPlayer2D::is_loop() const {
+	return loop;
+}
@@ -0,0 +1,64 @@
+#ifndef GHOST_PLAYER_2D
+#define GHOST_PLAYER_2D
+
+#include "scene/2d/node_2d.h"
+#include "core/templates/local_vector.h"
+#include "core/variant/typed_array.h"
+#include "scene/resources/texture.h"
+#include "../Bitwise/GhostRecording.h"
+
+// Draws GhostRecordings as textures interpolated between their ticks, without bodies or state machines.
+// Every ghost decodes one tick at a time while playing, many ghosts decode on the WorkerThreadPool.
+class GhostPlayer2D : public Node2D {
+	GDCLASS(GhostPlayer2D, Node2D);
+
+	struct Ghost {
+		Ref<GhostRecording> recording;
+		Ref<BaseStream> reader; // shares the bytes of the recording, the cursor is its own
+		GhostRecording::Frame previous;
+		GhostRecording::Frame current;
+		int tick = -1; // of current
+	};
+
+	TypedArray<GhostRecording> recordings;
+	Ref<Texture2D> texture;
+	double ticks_per_second = 0; // 0 follows the physics ticks per second
+	bool playing = false;
+	bool loop = false;
+
+	LocalVector<Ghost> ghosts;
+	double time = 0; // in ticks, the fraction interpolates between previous and current
+
+	void _rebuild();
+	void _rewind();
+	void _advance(const int p_tick);
+	void _advance_task(const uint32_t p_index, const int p_tick);
+	int _get_length() const;
+
+protected:
+	void _notification(int p_notification);
+	static void _bind_methods();
+public:
+	void set_recordings(const TypedArray<GhostRecording>& p_recordings);
+	TypedArray<GhostRecording> get_recordings() const;
+	void set_texture(const Ref<Texture2D>& p_texture);
+	Ref<Texture2D> get_texture() const;
+	void set_ticks_per_second(const double p_ticks);
+	double get_ticks_per_second() const;
+	void toggle_playing(const bool p_playing);
+	bool is_playing() const;
+	void toggle_loop(const bool p_loop);
+	bool is_loop() const;
+
+	void play();
+	void stop();
+	void seek(const double p_tick);
+	double get_time() const;
+
+	int get_ghost_count() const;
+	Vector2 get_ghost_position(const int p_index) const; // interpolated, in global coordinates
+	int get_ghost_state(const int p_index) const;
+	bool is_ghost_facing_right(const int p_index) const;
+};
+
+#endif
@@ -1,10 +1,17 @@
 #include "GroundedMovementData1D.h"
 
+#include "../Profiling/Tracer.h"
+
 Vector2 GroundedMovementData1D::_get_velocity(const GroundedMovementData1D::Data& p_data) const {
 	return Vector2((p_data.transitioning?
 		_assign_velocity(p_data.previous_speed.x, p_data.delta) : _update_velocity(p_data.previous_speed.x, p_data.delta)),
 	0);
 }
+Vector2 GroundedMovementData1D::_get_exact_velocity(const GroundedMovementData1D::Data& p_data, Vector2& r_end_velocity) const {
+	const real_t start = (p_data.transitioning ? _get_launch_speed(p_data.previous_speed.x) : p_data.previous_speed.x);
+	r_end_velocity = Vector2(_get_speed_at_time(start, p_data.delta), 0);
+	return Vector2((p_data.delta > 0 ? _get_distance_at_time(start, p_data.delta) / p_data.delta : start), 0);
+}
 GroundedMovementData1D::Data::Data(const Vector2 p_previous_speed, const double p_delta, const bool p_transitioning)
 	: previous_speed(p_previous_speed), delta(p_delta), transitioning(p_transitioning) {}
 
@@ -18,9 +25,33 @@ real_t GroundedMovementData1D::_assign_velocity(const real_t previous_speed, con
 	return MAX(MIN(speed + (previous_speed * scale_inherited_speed) + (acceleration * delta * 0.5), max_speed), min_speed);
 }
 
+real_t GroundedMovementData1D::_get_launch_speed(const real_t inherited_speed) const {
+	return MAX(MIN(speed + (inherited_speed * scale_inherited_speed), max_speed), min_speed);
+}
+real_t GroundedMovementData1D::_get_speed_at_time(const real_t launch_speed, const real_t time) const {
+	if (!acceleration)
+		return launch_speed;
+	return MAX(MIN(launch_speed + (acceleration * time), max_speed), min_speed);
+}
+real_t GroundedMovementData1D::_get_distance_at_time(const real_t launch_speed, const real_t time) const {
+	if (!acceleration)
+		return launch_speed * time;
+	const real_t start = MAX(MIN(launch_speed, max_speed), min_speed);
+	const real_t bound = acceleration > 0 ? max_speed : min_speed;
+	const real_t clamp_time = MAX((bound - start) / acceleration, 0.0);
+	if (time <= clamp_time)
+		return (start + (acceleration * time * 0.5)) * time;
+	return ((start + (acceleration * clamp_time * 0.5)) * clamp_time) + (bound * (time - clamp_time));
+}
+
 Vector2 GroundedMovementData1D::get_velocity(const Vector2 previous_speed, const double delta, const bool transitioning) const {
+	TRACE_SCOPE("GroundedMovementData1D::get_velocity");
 	return _get_velocity(Data(previous_speed, delta, transitioning));
 }
+Vector2 GroundedMovementData1D::get_exact_velocity(const Vector2 previous_speed, const double delta, const bool transitioning, Vector2& r_end_velocity) const {
+	TRACE_SCOPE("GroundedMovementData1D::get_exact_velocity");
+	return _get_exact_velocity(Data(previous_speed, delta, transitioning), r_end_velocity);
+}
 
 void GroundedMovementData1D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_velocity", "previous_speed", "delta_time", "transitioning"), &GroundedMovementData1D::get_velocity);
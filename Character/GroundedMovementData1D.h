@@ -20,9 +20,15 @@ protected:
 		Data(const Vector2 p_previous_speed, const double p_delta, const bool p_transitioning);
 	};
 	virtual Vector2 _get_velocity(const Data& p_data) const;
+	virtual Vector2 _get_exact_velocity(const Data& p_data, Vector2& r_end_velocity) const;
 	inline real_t _update_velocity(const real_t previous_speed, const double delta) const;
 	inline real_t _assign_velocity(const real_t previous_speed, const double delta) const;
 
+	//closed form of the velocity steps, time starts at the transition into this movement
+	real_t _get_launch_speed(const real_t inherited_speed) const;
+	real_t _get_speed_at_time(const real_t launch_speed, const real_t time) const;
+	real_t _get_distance_at_time(const real_t launch_speed, const real_t time) const;
+
 	static void _bind_methods();
 public:
 	void set_speed(const real_t p_speed);
@@ -37,6 +43,8 @@ public:
 	real_t get_scale_inherited_speed() const;
 
 	Vector2 get_velocity(const Vector2 previous_speed, const double delta, const bool transitioning = false) const;
+	//average velocity over the tick, so moving with it lands on the analytic curve at any tick rate
+	Vector2 get_exact_velocity(const Vector2 previous_speed, const double delta, const bool transitioning, Vector2& r_end_velocity) const;
 };
 
 #endif
@@ -0,0 +1,280 @@
+#include "InteractionServer.h"
+
+#include "Character2DSideScroller.h"
+
+InteractionServer2D* InteractionServer2D::singleton = nullptr;
+
+void InteractionServer2D::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_cell_size", "size"), &InteractionServer2D::set_cell_size);
+	ClassDB::bind_method(D_METHOD("get_cell_size"), &InteractionServer2D::get_cell_size);
+
+	ClassDB::bind_method(D_METHOD("find_nearest", "position", "radius", "facing", "mask"), &InteractionServer2D::find_nearest, DEFVAL(0), DEFVAL(0xFFFFFFFF));
+	ClassDB::bind_method(D_METHOD("find_nearest_for_characters", "characters", "radius", "mask"), &InteractionServer2D::find_nearest_for_characters, DEFVAL(0xFFFFFFFF));
+
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "cell_size"), "set_cell_size", "get_cell_size");
+}
+
+InteractionServer2D* InteractionServer2D::get_singleton() {
+	return singleton;
+}
+
+Rect2i InteractionServer2D::_get_cells(const Rect2& p_rect) const {
+	const Vector2i from = (p_rect.position / cell_size).floor();
+	const Vector2i to = (p_rect.get_end() / cell_size).floor();
+	return Rect2i(from, to - from);
+}
+
+void InteractionServer2D::_insert(const uint32_t p_item) {
+	const Rect2i& range = items[p_item].cells;
+	for (int y = range.position.y; y <= range.position.y + range.size.y; ++y) {
+		for (int x = range.position.x; x <= range.position.x + range.size.x; ++x) {
+			LocalVector<uint32_t>* cell = cells.getptr(Vector2i(x, y));
+			if (!cell)
+				cell = &cells.insert(Vector2i(x, y), LocalVector<uint32_t>())->value;
+			cell->push_back(p_item);
+		}
+	}
+}
+
+void InteractionServer2D::_remove(const uint32_t p_item) {
+	const Rect2i& range = items[p_item].cells;
+	for (int y = range.position.y; y <= range.position.y + range.size.y; ++y) {
+		for (int x = range.position.x; x <= range.position.x + range.size.x; ++x) {
+			LocalVector<uint32_t>* cell = cells.getptr(Vector2i(x, y));
+			ERR_CONTINUE(!cell);
+			const int64_t index = cell->find(p_item);
+			if (index >= 0)
+				cell->remove_at_unordered(index);
+			if (cell->is_empty())
+				cells.erase(Vector2i(x, y));
+		}
+	}
+}
+
+void InteractionServer2D::set_cell_size(const real_t p_size) {
+	ERR_FAIL_COND(p_size <= 0);
+	cell_size = p_size;
+	cells.clear();
+	for (uint32_t i = 0; i < items.size(); ++i) {
+		if (!items[i].active)
+			continue;
+		items[i].cells = _get_cells(items[i].rect);
+		_insert(i);
+	}
+}
+real_t InteractionServer2D::get_cell_size() const {
+	return cell_size;
+}
+
+uint32_t InteractionServer2D::item_create(const ObjectID p_object, const Rect2& p_rect, const uint32_t p_layers) {
+	uint32_t id;
+	if (free_items.is_empty()) {
+		id = items.size();
+		items.push_back(Item());
+	} else {
+		id = free_items[free_items.size() - 1];
+		free_items.resize(free_items.size() - 1);
+	}
+	Item& item = items[id];
+	item.object = p_object;
+	item.rect = p_rect.abs();
+	item.cells = _get_cells(item.rect);
+	item.layers = p_layers;
+	item.query_pass = 0;
+	item.active = true;
+	_insert(id);
+	return id;
+}
+
+void InteractionServer2D::item_set_rect(const uint32_t p_item, const Rect2& p_rect) {
+	ERR_FAIL_UNSIGNED_INDEX(p_item, items.size());
+	Item& item = items[p_item];
+	ERR_FAIL_COND(!item.active);
+	item.rect = p_rect.abs();
+	const Rect2i range = _get_cells(item.rect);
+	if (range == item.cells)
+		return;
+	_remove(p_item);
+	item.cells = range;
+	_insert(p_item);
+}
+
+void InteractionServer2D::item_set_layers(const uint32_t p_item, const uint32_t p_layers) {
+	ERR_FAIL_UNSIGNED_INDEX(p_item, items.size());
+	items[p_item].layers = p_layers;
+}
+
+void InteractionServer2D::item_free(const uint32_t p_item) {
+	ERR_FAIL_UNSIGNED_INDEX(p_item, items.size());
+	ERR_FAIL_COND(!items[p_item].active);
+	_remove(p_item);
+	items[p_item].active = false;
+	items[p_item].object = ObjectID();
+	free_items.push_back(p_item);
+}
+
+ObjectID InteractionServer2D::query_nearest(const Query& p_query) {
+	if (++query_pass == 0) { // wrapped around, stale passes could match again
+		for (uint32_t i = 0; i < items.size(); ++i)
+			items[i].query_pass = 0;
+		query_pass = 1;
+	}
+	const Vector2 extent = Vector2(p_query.radius, p_query.radius);
+	Rect2 bounds = Rect2(p_query.position - extent, extent * 2);
+	if (p_query.facing > 0) // only the cells in front
+		bounds = Rect2(p_query.position.x, bounds.position.y, p_query.radius, bounds.size.y);
+	else if (p_query.facing < 0)
+		bounds.size.x = p_query.radius;
+	const Rect2i range = _get_cells(bounds);
+
+	ObjectID res;
+	real_t nearest = p_query.radius * p_query.radius;
+	for (int y = range.position.y; y <= range.position.y + range.size.y; ++y) {
+		for (int x = range.position.x; x <= range.position.x + range.size.x; ++x) {
+			const LocalVector<uint32_t>* cell = cells.getptr(Vector2i(x, y));
+			if (!cell)
+				continue;
+			for (uint32_t i = 0; i < cell->size(); ++i) {
+				Item& item = items[(*cell)[i]];
+				if (item.query_pass == query_pass || !(item.layers & p_query.mask))
+					continue;
+				item.query_pass = query_pass;
+				const Vector2 closest = p_query.position.clamp(item.rect.position, item.rect.get_end());
+				if ((closest.x - p_query.position.x) * p_query.facing < 0)
+					continue;
+				const real_t distance = p_query.position.distance_squared_to(closest);
+				if (distance <= nearest) {
+					nearest = distance;
+					res = item.object;
+				}
+			}
+		}
+	}
+	return res;
+}
+
+void InteractionServer2D::query_nearest_batch(const Query* p_queries, const uint32_t p_count, ObjectID* r_results) {
+	for (uint32_t i = 0; i < p_count; ++i)
+		r_results[i] = query_nearest(p_queries[i]);
+}
+
+Object* InteractionServer2D::find_nearest(const Vector2 p_position, const real_t p_radius, const int p_facing, const uint32_t p_mask) {
+	Query query;
+	query.position = p_position;
+	query.radius = p_radius;
+	query.facing = SIGN(p_facing);
+	query.mask = p_mask;
+	return ObjectDB::get_instance(query_nearest(query));
+}
+
+Array InteractionServer2D::find_nearest_for_characters(const Array& p_characters, const real_t p_radius, const uint32_t p_mask) {
+	LocalVector<Query> queries;
+	queries.resize(p_characters.size());
+	for (int i = 0; i < p_characters.size(); ++i) {
+		const Node2D* node = Object::cast_to<Node2D>(p_characters[i]);
+		ERR_FAIL_NULL_V(node, Array());
+		const Character2DSideScroller* character = Object::cast_to<Character2DSideScroller>(node);
+		Query& query = queries[i];
+		query.position = node->get_global_position();
+		query.radius = p_radius;
+		query.facing = (character ? (character->is_facing_right() ? 1 : -1) : 0);
+		query.mask = p_mask;
+	}
+	LocalVector<ObjectID> results;
+	results.resize(queries.size());
+	query_nearest_batch(queries.ptr(), queries.size(), results.ptr());
+	Array res;
+	res.resize(results.size());
+	for (uint32_t i = 0; i < results.size(); ++i)
+		res[i] = ObjectDB::get_instance(results[i]);
+	return res;
+}
+
+InteractionServer2D::InteractionServer2D() {
+	singleton = this;
+}
+InteractionServer2D::~InteractionServer2D() {
+	singleton = nullptr;
+}
+
+void Interactable2D::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_size", "size"), &Interactable2D::set_size);
+	ClassDB::bind_method(D_METHOD("get_size"), &Interactable2D::get_size);
+	ClassDB::bind_method(D_METHOD("set_interaction_layers", "layers"), &Interactable2D::set_interaction_layers);
+	ClassDB::bind_method(D_METHOD("get_interaction_layers"), &Interactable2D::get_interaction_layers);
+	ClassDB::bind_method(D_METHOD("toggle_enabled", "enabled"), &Interactable2D::toggle_enabled);
+	ClassDB::bind_method(D_METHOD("is_enabled"), &Interactable2D::is_enabled);
+	ClassDB::bind_method(D_METHOD("interact", "by"), &Interactable2D::interact);
+
+	ADD_PROPERTY(PropertyInfo(Variant::VECTOR2, "size"), "set_size", "get_size");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "interaction_layers", PROPERTY_HINT_LAYERS_2D_PHYSICS), "set_interaction_layers", "get_interaction_layers");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "enabled"), "toggle_enabled", "is_enabled");
+
+	ADD_SIGNAL(MethodInfo("interacted", PropertyInfo(Variant::OBJECT, "by", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_DEFAULT, "Node")));
+}
+
+void Interactable2D::_notification(int p_notification) {
+	switch (p_notification) {
+		case NOTIFICATION_ENTER_TREE:
+			set_notify_transform(true);
+			_update_item();
+		break;
+		case NOTIFICATION_TRANSFORM_CHANGED:
+			if (item >= 0)
+				InteractionServer2D::get_singleton()->item_set_rect(item, _get_rect());
+		break;
+		case NOTIFICATION_EXIT_TREE:
+			if (item >= 0) {
+				InteractionServer2D::get_singleton()->item_free(item);
+				item = -1;
+			}
+		break;
+	};
+}
+
+Rect2 Interactable2D::_get_rect() const {
+	const Vector2 half = size * get_global_scale().abs() * 0.5;
+	return Rect2(get_global_position() - half, half * 2);
+}
+
+void Interactable2D::_update_item() {
+	InteractionServer2D* server = InteractionServer2D::get_singleton();
+	ERR_FAIL_NULL(server);
+	const bool registered = is_inside_tree() && enabled;
+	if (registered == (item >= 0))
+		return;
+	if (registered)
+		item = server->item_create(get_instance_id(), _get_rect(), interaction_layers);
+	else {
+		server->item_free(item);
+		item = -1;
+	}
+}
+
+void Interactable2D::set_size(const Vector2 p_size) {
+	size = p_size.abs();
+	if (item >= 0)
+		InteractionServer2D::get_singleton()->item_set_rect(item, _get_rect());
+}
+Vector2 Interactable2D::get_size() const {
+	return size;
+}
+void Interactable2D::set_interaction_layers(const uint32_t p_layers) {
+	interaction_layers = p_layers;
+	if (item >= 0)
+		InteractionServer2D::get_singleton()->item_set_layers(item, p_layers);
+}
+uint32_t Interactable2D::get_interaction_layers() const {
+	return interaction_layers;
+}
+void Interactable2D::toggle_enabled(const bool p_enabled) {
+	enabled = p_enabled;
+	_update_item();
+}
+bool Interactable2D::is_enabled() const {
+	return enabled;
+}
+
+void Interactable2D::interact(Node* p_by) {
+	emit_signal(SNAME("interacted"), p_by);
+}
@@ -0,0 +1,89 @@
+#ifndef INTERACTION_SERVER_2D
+#define INTERACTION_SERVER_2D
+
+#include "core/object/class_db.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "scene/2d/node_2d.h"
+
+// Uniform grid of interactable rects, replaces an Area2D per interactable and its overlap pairs.
+// Items are only rehashed when they move to different cells.
+class InteractionServer2D : public Object {
+	GDCLASS(InteractionServer2D, Object);
+
+	static InteractionServer2D* singleton;
+
+	struct Item {
+		ObjectID object;
+		Rect2 rect;
+		Rect2i cells; // cells covered, position is the first cell and end the last one
+		uint32_t layers = 1;
+		uint32_t query_pass = 0; // an item covering several cells is tested once per query
+		bool active = false;
+	};
+	LocalVector<Item> items;
+	LocalVector<uint32_t> free_items;
+	HashMap<Vector2i, LocalVector<uint32_t>> cells;
+	real_t cell_size = 128;
+	uint32_t query_pass = 0;
+
+	_FORCE_INLINE_ Rect2i _get_cells(const Rect2& p_rect) const;
+	void _insert(const uint32_t p_item);
+	void _remove(const uint32_t p_item);
+
+protected:
+	static void _bind_methods();
+public:
+	struct Query {
+		Vector2 position;
+		real_t radius = 0;
+		int8_t facing = 0; // 1 only to the right, -1 only to the left, 0 anywhere
+		uint32_t mask = 0xFFFFFFFF;
+	};
+
+	static InteractionServer2D* get_singleton();
+
+	void set_cell_size(const real_t p_size);
+	real_t get_cell_size() const;
+
+	uint32_t item_create(const ObjectID p_object, const Rect2& p_rect, const uint32_t p_layers = 1);
+	void item_set_rect(const uint32_t p_item, const Rect2& p_rect);
+	void item_set_layers(const uint32_t p_item, const uint32_t p_layers);
+	void item_free(const uint32_t p_item);
+
+	ObjectID query_nearest(const Query& p_query);
+	void query_nearest_batch(const Query* p_queries, const uint32_t p_count, ObjectID* r_results);
+
+	Object* find_nearest(const Vector2 p_position, const real_t p_radius, const int p_facing = 0, const uint32_t p_mask = 0xFFFFFFFF);
+	Array find_nearest_for_characters(const Array& p_characters, const real_t p_radius, const uint32_t p_mask = 0xFFFFFFFF); // faces the way each Character2DSideScroller does
+
+	InteractionServer2D();
+	~InteractionServer2D();
+};
+
+class Interactable2D : public Node2D {
+	GDCLASS(Interactable2D, Node2D);
+
+	Vector2 size = Vector2(32, 32); // centered on the node
+	uint32_t interaction_layers = 1;
+	bool enabled = true;
+	int64_t item = -1;
+
+	Rect2 _get_rect() const;
+	void _update_item();
+
+protected:
+	void _notification(int p_notification);
+	static void _bind_methods();
+public:
+	void set_size(const Vector2 p_size);
+	Vector2 get_size() const;
+	void set_interaction_layers(const uint32_t p_layers);
+	uint32_t get_interaction_layers() const;
+	void toggle_enabled(const bool p_enabled);
+	bool is_enabled() const;
+
+	void interact(Node* p_by);
+};
+
+#endif
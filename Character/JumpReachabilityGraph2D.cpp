@@ -0,0 +1,354 @@
+#include "JumpReachabilityGraph2D.h"
+
+#include "GroundedMovementData1D.h"
+#include "core/templates/hash_set.h"
+#include "scene/2d/tile_map.h"
+
+void JumpReachabilityGraph2D::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("bake_segments", "segments", "jumping_movement", "grounded_movement", "max_jump_count"), &JumpReachabilityGraph2D::bake_segments);
+	ClassDB::bind_method(D_METHOD("bake_tile_map", "tile_map", "layer", "jumping_movement", "grounded_movement", "max_jump_count"), &JumpReachabilityGraph2D::bake_tile_map);
+
+	ClassDB::bind_method(D_METHOD("get_segment_count"), &JumpReachabilityGraph2D::get_segment_count);
+	ClassDB::bind_method(D_METHOD("get_segment", "segment"), &JumpReachabilityGraph2D::get_segment);
+	ClassDB::bind_method(D_METHOD("find_segment", "position"), &JumpReachabilityGraph2D::find_segment);
+
+	ClassDB::bind_method(D_METHOD("get_edge_count"), &JumpReachabilityGraph2D::get_edge_count);
+	ClassDB::bind_method(D_METHOD("get_edge_source", "edge"), &JumpReachabilityGraph2D::get_edge_source);
+	ClassDB::bind_method(D_METHOD("get_edge_target", "edge"), &JumpReachabilityGraph2D::get_edge_target);
+	ClassDB::bind_method(D_METHOD("get_edge_profile", "edge"), &JumpReachabilityGraph2D::get_edge_profile);
+	ClassDB::bind_method(D_METHOD("get_edge_jump_count", "edge"), &JumpReachabilityGraph2D::get_edge_jump_count);
+	ClassDB::bind_method(D_METHOD("is_edge_facing_right", "edge"), &JumpReachabilityGraph2D::is_edge_facing_right);
+	ClassDB::bind_method(D_METHOD("get_edge_speed", "edge"), &JumpReachabilityGraph2D::get_edge_speed);
+	ClassDB::bind_method(D_METHOD("get_edge_time", "edge"), &JumpReachabilityGraph2D::get_edge_time);
+
+	ClassDB::bind_method(D_METHOD("find_path", "from_segment", "to_segment"), &JumpReachabilityGraph2D::find_path);
+
+	ClassDB::bind_method(D_METHOD("_set_segments", "segments"), &JumpReachabilityGraph2D::_set_segments);
+	ClassDB::bind_method(D_METHOD("_get_segments"), &JumpReachabilityGraph2D::_get_segments);
+	ClassDB::bind_method(D_METHOD("_set_edge_offsets", "offsets"), &JumpReachabilityGraph2D::_set_edge_offsets);
+	ClassDB::bind_method(D_METHOD("_get_edge_offsets"), &JumpReachabilityGraph2D::_get_edge_offsets);
+	ClassDB::bind_method(D_METHOD("_set_edge_targets", "targets"), &JumpReachabilityGraph2D::_set_edge_targets);
+	ClassDB::bind_method(D_METHOD("_get_edge_targets"), &JumpReachabilityGraph2D::_get_edge_targets);
+	ClassDB::bind_method(D_METHOD("_set_edge_flags", "flags"), &JumpReachabilityGraph2D::_set_edge_flags);
+	ClassDB::bind_method(D_METHOD("_get_edge_flags"), &JumpReachabilityGraph2D::_get_edge_flags);
+	ClassDB::bind_method(D_METHOD("_set_edge_speeds", "speeds"), &JumpReachabilityGraph2D::_set_edge_speeds);
+	ClassDB::bind_method(D_METHOD("_get_edge_speeds"), &JumpReachabilityGraph2D::_get_edge_speeds);
+	ClassDB::bind_method(D_METHOD("_set_edge_times", "times"), &JumpReachabilityGraph2D::_set_edge_times);
+	ClassDB::bind_method(D_METHOD("_get_edge_times"), &JumpReachabilityGraph2D::_get_edge_times);
+	ClassDB::bind_method(D_METHOD("_set_heuristic_speed", "speed"), &JumpReachabilityGraph2D::_set_heuristic_speed);
+	ClassDB::bind_method(D_METHOD("_get_heuristic_speed"), &JumpReachabilityGraph2D::_get_heuristic_speed);
+
+	ADD_PROPERTY(PropertyInfo(Variant::PACKED_VECTOR3_ARRAY, "segments", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR), "_set_segments", "_get_segments");
+	ADD_PROPERTY(PropertyInfo(Variant::PACKED_INT32_ARRAY, "edge_offsets", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR), "_set_edge_offsets", "_get_edge_offsets");
+	ADD_PROPERTY(PropertyInfo(Variant::PACKED_INT32_ARRAY, "edge_targets", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR), "_set_edge_targets", "_get_edge_targets");
+	ADD_PROPERTY(PropertyInfo(Variant::PACKED_INT32_ARRAY, "edge_flags", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR), "_set_edge_flags", "_get_edge_flags");
+	ADD_PROPERTY(PropertyInfo(Variant::PACKED_FLOAT32_ARRAY, "edge_speeds", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR), "_set_edge_speeds", "_get_edge_speeds");
+	ADD_PROPERTY(PropertyInfo(Variant::PACKED_FLOAT32_ARRAY, "edge_times", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR), "_set_edge_times", "_get_edge_times");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "heuristic_speed", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR), "_set_heuristic_speed", "_get_heuristic_speed");
+
+	BIND_ENUM_CONSTANT(EDGE_PROFILE_MASK);
+	BIND_ENUM_CONSTANT(EDGE_JUMP_COUNT_SHIFT);
+	BIND_ENUM_CONSTANT(EDGE_JUMP_COUNT_MASK);
+	BIND_ENUM_CONSTANT(EDGE_FACING_RIGHT);
+}
+
+static const int jump_speed_iterations = 24;
+
+// Horizontal distance covered landing p_drop lower, -1 when the jumps can't climb that high.
+real_t JumpReachabilityGraph2D::_get_jump_distance(const MovementData2D* p_movement, const real_t p_speed, const int p_jump_count, const real_t p_drop, real_t& r_time) {
+	const real_t gravity = p_movement->get_gravity();
+	if (!p_jump_count) { // walking off the edge
+		if (p_drop <= 0)
+			return -1;
+		r_time = Math::sqrt(2.0 * p_drop / gravity);
+		return p_speed * r_time;
+	}
+	// every extra jump starts at the apex of the previous one
+	const Vector2 inherited = Vector2(p_speed, 0);
+	const real_t apex_time = p_movement->get_apex_time(inherited);
+	const real_t apex_speed = p_movement->get_velocity_at_time(inherited, apex_time).x;
+	const real_t fall = (p_movement->get_apex_height(inherited) * p_jump_count) + p_drop;
+	if (fall < 0)
+		return -1;
+	const real_t fall_time = Math::sqrt(2.0 * fall / gravity);
+	r_time = (apex_time * p_jump_count) + fall_time;
+	return p_movement->get_position_at_time(inherited, apex_time).x + (apex_speed * ((apex_time * (p_jump_count - 1)) + fall_time));
+}
+
+// The distance only grows with the run-up speed, so the slowest run-up reaching the segment is found by bisection.
+bool JumpReachabilityGraph2D::_find_jump(const MovementData2D* p_movement, const real_t p_max_run_speed, const int p_max_jump_count, const Vector3& p_from, const Vector3& p_to, const bool p_facing_right, Jump& r_jump) {
+	if (p_movement->get_gravity() <= 0)
+		return false;
+	const real_t takeoff = p_facing_right ? p_from.y : p_from.x;
+	const real_t drop = p_to.z - p_from.z; // y points down, positive when landing lower
+	const real_t nearest = MAX(p_facing_right ? p_to.x - takeoff : takeoff - p_to.y, (real_t)0);
+	const real_t farthest = p_facing_right ? p_to.y - takeoff : takeoff - p_to.x;
+	if (farthest < 0)
+		return false;
+	for (int jump_count = 0; jump_count <= p_max_jump_count; ++jump_count) {
+		real_t time = 0;
+		if (_get_jump_distance(p_movement, p_max_run_speed, jump_count, drop, time) < nearest)
+			continue;
+		real_t low = 0, high = p_max_run_speed;
+		if (_get_jump_distance(p_movement, 0, jump_count, drop, time) < nearest) {
+			for (int i = 0; i < jump_speed_iterations; ++i) {
+				const real_t mid = (low + high) * 0.5;
+				if (_get_jump_distance(p_movement, mid, jump_count, drop, time) < nearest)
+					low = mid;
+				else
+					high = mid;
+			}
+		} else
+			high = 0;
+		if (_get_jump_distance(p_movement, high, jump_count, drop, time) > farthest)
+			continue; // even the slowest run-up landing far enough overshoots
+		r_jump.speed = high;
+		r_jump.time = time;
+		r_jump.jump_count = jump_count;
+		return true;
+	}
+	return false;
+}
+
+void JumpReachabilityGraph2D::bake_segments(const PackedVector3Array& p_segments, const Array& p_jumping_movement, const Array& p_grounded_movement, const int p_max_jump_count) {
+	ERR_FAIL_COND(p_jumping_movement.size() > EDGE_PROFILE_MASK + 1);
+	const int max_jump_count = CLAMP(p_max_jump_count, 0, EDGE_JUMP_COUNT_MASK >> EDGE_JUMP_COUNT_SHIFT);
+
+	real_t max_run_speed = 0;
+	for (int i = 0; i < p_grounded_movement.size(); ++i) {
+		const GroundedMovementData1D* grounded = Object::cast_to<GroundedMovementData1D>(p_grounded_movement[i]);
+		ERR_CONTINUE(!grounded);
+		max_run_speed = MAX(max_run_speed, MAX(Math::abs(grounded->get_speed()), Math::abs(grounded->get_max_speed())));
+	}
+	heuristic_speed = 0;
+
+	segments = p_segments;
+	edge_offsets.resize(segments.size() + 1);
+	edge_targets.clear();
+	edge_flags.clear();
+	edge_speeds.clear();
+	edge_times.clear();
+	for (int from = 0; from < segments.size(); ++from) {
+		edge_offsets.set(from, edge_targets.size());
+		for (int to = 0; to < segments.size(); ++to) {
+			if (from == to)
+				continue;
+			for (int profile = 0; profile < p_jumping_movement.size(); ++profile) {
+				const MovementData2D* movement = Object::cast_to<MovementData2D>(p_jumping_movement[profile]);
+				ERR_CONTINUE(!movement);
+				Jump best;
+				bool best_facing_right = false;
+				bool found = false;
+				for (const bool facing_right : { false, true }) {
+					Jump jump;
+					if (!_find_jump(movement, max_run_speed, max_jump_count, segments[from], segments[to], facing_right, jump))
+						continue;
+					if (!found || jump.jump_count < best.jump_count || (jump.jump_count == best.jump_count && jump.time < best.time)) {
+						best = jump;
+						best_facing_right = facing_right;
+						found = true;
+					}
+				}
+				if (!found)
+					continue;
+				edge_targets.push_back(to);
+				edge_flags.push_back(profile | (best.jump_count << EDGE_JUMP_COUNT_SHIFT) | (best_facing_right ? EDGE_FACING_RIGHT : 0));
+				edge_speeds.push_back(best.speed);
+				edge_times.push_back(best.time);
+				if (best.time > 0)
+					heuristic_speed = MAX(heuristic_speed, Math::abs(segments[to].z - segments[from].z) / best.time);
+			}
+		}
+	}
+	edge_offsets.set(segments.size(), edge_targets.size());
+	emit_changed();
+}
+
+void JumpReachabilityGraph2D::bake_tile_map(Node* p_tile_map, const int p_layer, const Array& p_jumping_movement, const Array& p_grounded_movement, const int p_max_jump_count) {
+	const TileMap* tile_map = Object::cast_to<TileMap>(p_tile_map);
+	ERR_FAIL_NULL(tile_map);
+	ERR_FAIL_COND(tile_map->get_tileset().is_null());
+
+	const TypedArray<Vector2i> cells = tile_map->get_used_cells(p_layer);
+	HashSet<Vector2i> occupied;
+	for (int i = 0; i < cells.size(); ++i)
+		occupied.insert(cells[i]);
+
+	Vector<Vector2i> surfaces; // stored as (y, x) so sorting walks each row left to right
+	for (int i = 0; i < cells.size(); ++i) {
+		const Vector2i cell = cells[i];
+		if (!occupied.has(cell + Vector2i(0, -1)))
+			surfaces.push_back(Vector2i(cell.y, cell.x));
+	}
+	surfaces.sort();
+
+	const Vector2 half_tile = Vector2(tile_map->get_tileset()->get_tile_size()) * 0.5;
+	const Transform2D xform = tile_map->get_global_transform();
+	PackedVector3Array platform_segments;
+	for (int i = 0; i < surfaces.size();) {
+		int end = i;
+		while (end + 1 < surfaces.size() && surfaces[end + 1].x == surfaces[i].x && surfaces[end + 1].y == surfaces[end].y + 1)
+			++end;
+		const Vector2 left = xform.xform(tile_map->map_to_local(Vector2i(surfaces[i].y, surfaces[i].x)) - half_tile);
+		const Vector2 right = xform.xform(tile_map->map_to_local(Vector2i(surfaces[end].y, surfaces[end].x)) + Vector2(half_tile.x, -half_tile.y));
+		platform_segments.push_back(Vector3(left.x, right.x, left.y));
+		i = end + 1;
+	}
+	bake_segments(platform_segments, p_jumping_movement, p_grounded_movement, p_max_jump_count);
+}
+
+int JumpReachabilityGraph2D::get_segment_count() const {
+	return segments.size();
+}
+Vector3 JumpReachabilityGraph2D::get_segment(const int p_segment) const {
+	ERR_FAIL_INDEX_V(p_segment, segments.size(), Vector3());
+	return segments[p_segment];
+}
+int JumpReachabilityGraph2D::find_segment(const Vector2 p_position) const {
+	int res = -1;
+	real_t closest = 0;
+	for (int i = 0; i < segments.size(); ++i) {
+		const Vector3& segment = segments[i];
+		if (p_position.x < segment.x || p_position.x > segment.y || segment.z < p_position.y)
+			continue;
+		if (res == -1 || (segment.z - p_position.y) < closest) {
+			res = i;
+			closest = segment.z - p_position.y;
+		}
+	}
+	return res;
+}
+
+int JumpReachabilityGraph2D::get_edge_count() const {
+	return edge_targets.size();
+}
+int JumpReachabilityGraph2D::get_edge_source(const int p_edge) const {
+	ERR_FAIL_INDEX_V(p_edge, edge_targets.size(), -1);
+	int low = 0, high = segments.size() - 1;
+	while (low < high) {
+		const int mid = (low + high + 1) / 2;
+		if (edge_offsets[mid] <= p_edge)
+			low = mid;
+		else
+			high = mid - 1;
+	}
+	return low;
+}
+int JumpReachabilityGraph2D::get_edge_target(const int p_edge) const {
+	ERR_FAIL_INDEX_V(p_edge, edge_targets.size(), -1);
+	return edge_targets[p_edge];
+}
+int JumpReachabilityGraph2D::get_edge_profile(const int p_edge) const {
+	ERR_FAIL_INDEX_V(p_edge, edge_flags.size(), -1);
+	return edge_flags[p_edge] & EDGE_PROFILE_MASK;
+}
+int JumpReachabilityGraph2D::get_edge_jump_count(const int p_edge) const {
+	ERR_FAIL_INDEX_V(p_edge, edge_flags.size(), 0);
+	return (edge_flags[p_edge] & EDGE_JUMP_COUNT_MASK) >> EDGE_JUMP_COUNT_SHIFT;
+}
+bool JumpReachabilityGraph2D::is_edge_facing_right(const int p_edge) const {
+	ERR_FAIL_INDEX_V(p_edge, edge_flags.size(), false);
+	return edge_flags[p_edge] & EDGE_FACING_RIGHT;
+}
+real_t JumpReachabilityGraph2D::get_edge_speed(const int p_edge) const {
+	ERR_FAIL_INDEX_V(p_edge, edge_speeds.size(), 0);
+	return edge_speeds[p_edge];
+}
+real_t JumpReachabilityGraph2D::get_edge_time(const int p_edge) const {
+	ERR_FAIL_INDEX_V(p_edge, edge_times.size(), 0);
+	return edge_times[p_edge];
+}
+
+PackedInt32Array JumpReachabilityGraph2D::find_path(const int p_from_segment, const int p_to_segment) const {
+	PackedInt32Array res;
+	ERR_FAIL_INDEX_V(p_from_segment, segments.size(), res);
+	ERR_FAIL_INDEX_V(p_to_segment, segments.size(), res);
+	ERR_FAIL_COND_V(edge_offsets.size() != segments.size() + 1, res);
+
+	const real_t goal_height = segments[p_to_segment].z;
+	const int count = segments.size();
+	LocalVector<real_t> cost;
+	LocalVector<real_t> estimate;
+	LocalVector<int> came_by; // edge taken into the segment
+	LocalVector<uint8_t> open; // 0 unvisited, 1 open, 2 closed
+	cost.resize(count);
+	estimate.resize(count);
+	came_by.resize(count);
+	open.resize(count);
+	for (int i = 0; i < count; ++i) {
+		came_by[i] = -1;
+		open[i] = 0;
+	}
+	cost[p_from_segment] = 0;
+	estimate[p_from_segment] = 0;
+	open[p_from_segment] = 1;
+
+	while (true) {
+		int current = -1;
+		for (int i = 0; i < count; ++i)
+			if (open[i] == 1 && (current == -1 || estimate[i] < estimate[current]))
+				current = i;
+		if (current == -1)
+			return res;
+		if (current == p_to_segment)
+			break;
+		open[current] = 2;
+		for (int edge = edge_offsets[current]; edge < edge_offsets[current + 1]; ++edge) {
+			const int next = edge_targets[edge];
+			const real_t next_cost = cost[current] + edge_times[edge];
+			if (open[next] == 2 || (open[next] == 1 && next_cost >= cost[next]))
+				continue;
+			cost[next] = next_cost;
+			estimate[next] = next_cost + (heuristic_speed > 0 ? Math::abs(segments[next].z - goal_height) / heuristic_speed : 0);
+			came_by[next] = edge;
+			open[next] = 1;
+		}
+	}
+	for (int segment = p_to_segment; came_by[segment] != -1; segment = get_edge_source(came_by[segment]))
+		res.push_back(came_by[segment]);
+	res.reverse();
+	return res;
+}
+
+void JumpReachabilityGraph2D::_set_segments(const PackedVector3Array& p_segments) {
+	segments = p_segments;
+}
+PackedVector3Array JumpReachabilityGraph2D::_get_segments() const {
+	return segments;
+}
+void JumpReachabilityGraph2D::_set_edge_offsets(const PackedInt32Array& p_offsets) {
+	edge_offsets = p_offsets;
+}
+PackedInt32Array JumpReachabilityGraph2D::_get_edge_offsets() const {
+	return edge_offsets;
+}
+void JumpReachabilityGraph2D::_set_edge_targets(const PackedInt32Array& p_targets) {
+	edge_targets = p_targets;
+}
+PackedInt32Array JumpReachabilityGraph2D::_get_edge_targets() const {
+	return edge_targets;
+}
+void JumpReachabilityGraph2D::_set_edge_flags(const PackedInt32Array& p_flags) {
+	edge_flags = p_flags;
+}
+PackedInt32Array JumpReachabilityGraph2D::_get_edge_flags() const {
+	return edge_flags;
+}
+void JumpReachabilityGraph2D::_set_edge_speeds(const PackedFloat32Array& p_speeds) {
+	edge_speeds = p_speeds;
+}
+PackedFloat32Array JumpReachabilityGraph2D::_get_edge_speeds() const {
+	return edge_speeds;
+}
+void JumpReachabilityGraph2D::_set_edge_times(const PackedFloat32Array& p_times) {
+	edge_times = p_times;
+}
+PackedFloat32Array JumpReachabilityGraph2D::_get_edge_times() const {
+	return edge_times;
+}
+void JumpReachabilityGraph2D::_set_heuristic_speed(const real_t p_speed) {
+	heuristic_speed = p_speed;
+}
+real_t JumpReachabilityGraph2D::_get_heuristic_speed() const {
+	return heuristic_speed;
+}
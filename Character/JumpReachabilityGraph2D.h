@@ -0,0 +1,74 @@
+#ifndef JUMP_REACHABILITY_GRAPH_2D
+#define JUMP_REACHABILITY_GRAPH_2D
+
+#include "core/io/resource.h"
+#include "MovementData2D.h"
+
+class JumpReachabilityGraph2D : public Resource {
+	GDCLASS(JumpReachabilityGraph2D, Resource);
+	OBJ_SAVE_TYPE(JumpReachabilityGraph2D);
+
+public:
+	enum EdgeFlags {
+		EDGE_PROFILE_MASK = 0xFF,
+		EDGE_JUMP_COUNT_SHIFT = 8,
+		EDGE_JUMP_COUNT_MASK = 0xF << EDGE_JUMP_COUNT_SHIFT, // 0 is walking off the edge
+		EDGE_FACING_RIGHT = 1 << 12
+	};
+
+private:
+	PackedVector3Array segments; // x is the left end, y the right end and z the height of a walkable platform
+	PackedInt32Array edge_offsets; // edges leaving segment i are [edge_offsets[i], edge_offsets[i + 1])
+	PackedInt32Array edge_targets;
+	PackedInt32Array edge_flags;
+	PackedFloat32Array edge_speeds; // run-up speed
+	PackedFloat32Array edge_times; // time in the air
+	real_t heuristic_speed = 0; // vertical, walking is free so only the height left to cover bounds the remaining time
+
+	struct Jump {
+		real_t speed = 0;
+		real_t time = 0;
+		uint8_t jump_count = 0;
+	};
+
+protected:
+	static void _bind_methods();
+public:
+	void bake_segments(const PackedVector3Array& p_segments, const Array& p_jumping_movement, const Array& p_grounded_movement, const int p_max_jump_count);
+	void bake_tile_map(Node* p_tile_map, const int p_layer, const Array& p_jumping_movement, const Array& p_grounded_movement, const int p_max_jump_count);
+
+	int get_segment_count() const;
+	Vector3 get_segment(const int p_segment) const;
+	int find_segment(const Vector2 p_position) const;
+
+	int get_edge_count() const;
+	int get_edge_source(const int p_edge) const;
+	int get_edge_target(const int p_edge) const;
+	int get_edge_profile(const int p_edge) const;
+	int get_edge_jump_count(const int p_edge) const;
+	bool is_edge_facing_right(const int p_edge) const;
+	real_t get_edge_speed(const int p_edge) const;
+	real_t get_edge_time(const int p_edge) const;
+
+	PackedInt32Array find_path(const int p_from_segment, const int p_to_segment) const; // edge indices, empty when unreachable
+
+	void _set_segments(const PackedVector3Array& p_segments);
+	PackedVector3Array _get_segments() const;
+	void _set_edge_offsets(const PackedInt32Array& p_offsets);
+	PackedInt32Array _get_edge_offsets() const;
+	void _set_edge_targets(const PackedInt32Array& p_targets);
+	PackedInt32Array _get_edge_targets() const;
+	void _set_edge_flags(const PackedInt32Array& p_flags);
+	PackedInt32Array _get_edge_flags() const;
+	void _set_edge_speeds(const PackedFloat32Array& p_speeds);
+	PackedFloat32Array _get_edge_speeds() const;
+	void _set_edge_times(const PackedFloat32Array& p_times);
+	PackedFloat32Array _get_edge_times() const;
+	void _set_heuristic_speed(const real_t p_speed);
+	real_t _get_heuristic_speed() const;
+private:
+	static real_t _get_jump_distance(const MovementData2D* p_movement, const real_t p_speed, const int p_jump_count, const real_t p_drop, real_t& r_time);
+	static bool _find_jump(const MovementData2D* p_movement, const real_t p_max_run_speed, const int p_max_jump_count, const Vector3& p_from, const Vector3& p_to, const bool p_facing_right, Jump& r_jump);
+};
+
+#endif
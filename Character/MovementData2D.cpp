@@ -8,7 +8,63 @@ Vector2 MovementData2D::_get_velocity(const GroundedMovementData1D::Data& p_data
 	);
 	return res;
 }
+Vector2 MovementData2D::_get_exact_velocity(const GroundedMovementData1D::Data& p_data, Vector2& r_end_velocity) const {
+	Vector2 res = GroundedMovementData1D::_get_exact_velocity(p_data, r_end_velocity);
+	const real_t start = (p_data.transitioning ? _get_launch_ySpeed(p_data.previous_speed) : p_data.previous_speed.y);
+	r_end_velocity.y = start + (gravity * p_data.delta);
+	res.y = start + (gravity * p_data.delta * 0.5);
+	return res;
+}
+
+real_t MovementData2D::_get_launch_ySpeed(const Vector2 inherited_velocity) const {
+	return -initial_jump_velocity - (Math::abs(inherited_velocity.x) * xVel_to_yVel_ratio) + (inherited_velocity.y * scale_inherited_ySpeed);
+}
 
+Vector2 MovementData2D::get_launch_velocity(const Vector2 inherited_velocity) const {
+	return Vector2(_get_launch_speed(inherited_velocity.x), _get_launch_ySpeed(inherited_velocity));
+}
+Vector2 MovementData2D::get_velocity_at_time(const Vector2 inherited_velocity, const real_t time) const {
+	return Vector2(_get_speed_at_time(_get_launch_speed(inherited_velocity.x), time), _get_launch_ySpeed(inherited_velocity) + (gravity * time));
+}
+Vector2 MovementData2D::get_position_at_time(const Vector2 inherited_velocity, const real_t time) const {
+	return Vector2(_get_distance_at_time(_get_launch_speed(inherited_velocity.x), time), (_get_launch_ySpeed(inherited_velocity) + (gravity * time * 0.5)) * time);
+}
+real_t MovementData2D::get_apex_time(const Vector2 inherited_velocity) const {
+	const real_t ySpeed = _get_launch_ySpeed(inherited_velocity);
+	if (ySpeed >= 0 || gravity <= 0)
+		return 0;
+	return -ySpeed / gravity;
+}
+real_t MovementData2D::get_apex_height(const Vector2 inherited_velocity) const {
+	const real_t ySpeed = _get_launch_ySpeed(inherited_velocity);
+	if (ySpeed >= 0 || gravity <= 0)
+		return 0;
+	return (ySpeed * ySpeed) / (2.0 * gravity);
+}
+real_t MovementData2D::get_time_to_height(const Vector2 inherited_velocity, const real_t height, const bool descending) const {
+	// solves height = -(ySpeed * t + gravity * t^2 / 2) for t >= 0
+	const real_t ySpeed = _get_launch_ySpeed(inherited_velocity);
+	if (!gravity) {
+		if (!ySpeed || (-height / ySpeed) < 0)
+			return -1;
+		return -height / ySpeed;
+	}
+	const real_t discriminant = (ySpeed * ySpeed) - (2.0 * gravity * height);
+	if (discriminant < 0)
+		return -1;
+	const real_t root = Math::sqrt(discriminant);
+	const real_t time = (-ySpeed + (descending ? root : -root)) / gravity;
+	if (time >= 0)
+		return time;
+	const real_t other_time = (-ySpeed + (descending ? -root : root)) / gravity;
+	return other_time >= 0 ? other_time : -1;
+}
+real_t MovementData2D::get_horizontal_reach(const Vector2 inherited_velocity, const real_t height) const {
+	const real_t time = get_time_to_height(inherited_velocity, height, true);
+	if (time < 0)
+		return 0;
+	return _get_distance_at_time(_get_launch_speed(inherited_velocity.x), time);
+}
 
 void MovementData2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_jump_height", "jump_height"), &MovementData2D::set_jump_height);
@@ -31,6 +87,14 @@ void MovementData2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_scale_inherited_ySpeed", "scale"), &MovementData2D::set_scale_inherited_ySpeed);
 	ClassDB::bind_method(D_METHOD("get_scale_inherited_ySpeed"), &MovementData2D::get_scale_inherited_ySpeed);
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "scale_inherited_ySpeed"), "set_scale_inherited_ySpeed", "get_scale_inherited_ySpeed");
+
+	ClassDB::bind_method(D_METHOD("get_launch_velocity", "inherited_velocity"), &MovementData2D::get_launch_velocity);
+	ClassDB::bind_method(D_METHOD("get_velocity_at_time", "inherited_velocity", "time"), &MovementData2D::get_velocity_at_time);
+	ClassDB::bind_method(D_METHOD("get_position_at_time", "inherited_velocity", "time"), &MovementData2D::get_position_at_time);
+	ClassDB::bind_method(D_METHOD("get_apex_time", "inherited_velocity"), &MovementData2D::get_apex_time);
+	ClassDB::bind_method(D_METHOD("get_apex_height", "inherited_velocity"), &MovementData2D::get_apex_height);
+	ClassDB::bind_method(D_METHOD("get_time_to_height", "inherited_velocity", "height", "descending"), &MovementData2D::get_time_to_height, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("get_horizontal_reach", "inherited_velocity", "height"), &MovementData2D::get_horizontal_reach, DEFVAL(0));
 }
 
 void MovementData2D::_update_jump_cache() {
@@ -16,6 +16,7 @@ private:
 	real_t scale_inherited_ySpeed = 0;
 protected:
 	Vector2 _get_velocity(const Data& p_data) const override;
+	Vector2 _get_exact_velocity(const Data& p_data, Vector2& r_end_velocity) const override;
 
 	static void _bind_methods();
 public:
@@ -30,7 +31,17 @@ public:
 	real_t get_xVel2yVel_ratio() const;
 	void set_scale_inherited_ySpeed(const real_t p_scale);
 	real_t get_scale_inherited_ySpeed() const;
+
+	//trajectory queries, time starts at the jump and y points down like the velocity does
+	Vector2 get_launch_velocity(const Vector2 inherited_velocity) const;
+	Vector2 get_velocity_at_time(const Vector2 inherited_velocity, const real_t time) const;
+	Vector2 get_position_at_time(const Vector2 inherited_velocity, const real_t time) const;
+	real_t get_apex_time(const Vector2 inherited_velocity) const;
+	real_t get_apex_height(const Vector2 inherited_velocity) const;
+	real_t get_time_to_height(const Vector2 inherited_velocity, const real_t height, const bool descending = true) const; // -1 when never reached
+	real_t get_horizontal_reach(const Vector2 inherited_velocity, const real_t height = 0) const;
 private:
+	inline real_t _get_launch_ySpeed(const Vector2 inherited_velocity) const;
 	void _update_jump_cache();
 };
 
@@ -0,0 +1,209 @@
+#include "MovementSet.h"
+
+#include "core/io/file_access.h"
+#include "core/io/marshalls.h"
+
+static const uint32_t movement_set_magic = 0x5453564D; // "MVST" little endian
+static const uint32_t movement_set_version = 1;
+static const uint32_t max_state_count = 16; // the state bits hold 4 bits per movement index
+
+void MovementSet::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("build", "grounded_movement", "jumping_movement"), &MovementSet::build);
+	ClassDB::bind_method(D_METHOD("get_grounded_count"), &MovementSet::get_grounded_count);
+	ClassDB::bind_method(D_METHOD("get_jumping_count"), &MovementSet::get_jumping_count);
+	ClassDB::bind_method(D_METHOD("get_grounded_movement_data"), &MovementSet::get_grounded_movement_data);
+	ClassDB::bind_method(D_METHOD("get_jumping_movement_data"), &MovementSet::get_jumping_movement_data);
+
+	ClassDB::bind_method(D_METHOD("_set_data", "data"), &MovementSet::_set_data);
+	ClassDB::bind_method(D_METHOD("get_data"), &MovementSet::get_data);
+	ADD_PROPERTY(PropertyInfo(Variant::PACKED_BYTE_ARRAY, "data", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR), "_set_data", "get_data");
+}
+
+void MovementSet::_read_profile(const GroundedMovementData1D* p_data, Profile& r_profile) {
+	r_profile.speed = p_data->get_speed();
+	r_profile.acceleration = p_data->get_acceleration();
+	r_profile.max_speed = p_data->get_max_speed();
+	r_profile.min_speed = p_data->get_min_speed();
+	r_profile.scale_inherited_speed = p_data->get_scale_inherited_speed();
+}
+void MovementSet::_read_profile(const MovementData2D* p_data, Profile& r_profile) {
+	_read_profile((const GroundedMovementData1D*)p_data, r_profile);
+	r_profile.jump_height = p_data->get_jump_height();
+	r_profile.jump_duration = p_data->get_jump_duration();
+	r_profile.xVel_to_yVel_ratio = p_data->get_xVel2yVel_ratio();
+	r_profile.scale_inherited_ySpeed = p_data->get_scale_inherited_ySpeed();
+}
+
+void MovementSet::_materialize(const LocalVector<Profile>& p_profiles, const uint32_t p_grounded_count) {
+	grounded_count = p_grounded_count;
+	grounded.resize(grounded_count);
+	for (uint32_t i = 0; i < grounded_count; ++i) {
+		const Profile& profile = p_profiles[i];
+		Ref<GroundedMovementData1D> data;
+		data.instantiate();
+		data->set_speed(profile.speed);
+		data->set_acceleration(profile.acceleration);
+		data->set_max_speed(profile.max_speed);
+		data->set_min_speed(profile.min_speed);
+		data->set_scale_inherited_speed(profile.scale_inherited_speed);
+		grounded.set(i, data);
+	}
+	jumping.resize(p_profiles.size() - grounded_count);
+	for (uint32_t i = grounded_count; i < p_profiles.size(); ++i) {
+		const Profile& profile = p_profiles[i];
+		Ref<MovementData2D> data;
+		data.instantiate();
+		data->set_speed(profile.speed);
+		data->set_acceleration(profile.acceleration);
+		data->set_max_speed(profile.max_speed);
+		data->set_min_speed(profile.min_speed);
+		data->set_scale_inherited_speed(profile.scale_inherited_speed);
+		data->set_jump_height(profile.jump_height);
+		data->set_jump_duration(profile.jump_duration);
+		data->set_xVel2yVel_ratio(profile.xVel_to_yVel_ratio);
+		data->set_scale_inherited_ySpeed(profile.scale_inherited_ySpeed);
+		jumping.set(i - grounded_count, data);
+	}
+}
+
+// meant to be built once, characters already using the set keep the movement data they got
+void MovementSet::build(const Array& p_grounded, const Array& p_jumping) {
+	ERR_FAIL_COND(p_grounded.size() >= (int)max_state_count || p_jumping.size() >= (int)max_state_count);
+	LocalVector<Profile> list;
+	list.resize(p_grounded.size() + p_jumping.size());
+	for (int i = 0; i < p_grounded.size(); ++i) {
+		const GroundedMovementData1D* data = Object::cast_to<GroundedMovementData1D>(p_grounded[i]);
+		ERR_FAIL_NULL_MSG(data, "Every grounded movement of a MovementSet has to be a GroundedMovementData1D.");
+		_read_profile(data, list[i]);
+	}
+	for (int i = 0; i < p_jumping.size(); ++i) {
+		const MovementData2D* data = Object::cast_to<MovementData2D>(p_jumping[i]);
+		ERR_FAIL_NULL_MSG(data, "Every jumping movement of a MovementSet has to be a MovementData2D.");
+		_read_profile(data, list[p_grounded.size() + i]);
+	}
+	_materialize(list, p_grounded.size());
+	emit_changed();
+}
+
+int MovementSet::get_grounded_count() const {
+	return grounded_count;
+}
+int MovementSet::get_jumping_count() const {
+	return jumping.size();
+}
+MovementSet::Profile MovementSet::get_profile(const int p_index) const {
+	CRASH_BAD_INDEX(p_index, (int)grounded_count + jumping.size());
+	Profile profile;
+	if (p_index < (int)grounded_count)
+		_read_profile(grounded[p_index].ptr(), profile);
+	else
+		_read_profile(jumping[p_index - grounded_count].ptr(), profile);
+	return profile;
+}
+Array MovementSet::get_grounded_movement_data() const {
+	Array res;
+	for (int i = 0; i < grounded.size(); ++i)
+		res.push_back(grounded[i]);
+	return res;
+}
+Array MovementSet::get_jumping_movement_data() const {
+	Array res;
+	for (int i = 0; i < jumping.size(); ++i)
+		res.push_back(jumping[i]);
+	return res;
+}
+
+// little endian 32 bit fields, the header and then every profile at a fixed stride
+Error MovementSet::set_data(const PackedByteArray& p_data) {
+	ERR_FAIL_COND_V_MSG(p_data.size() < (int)HEADER_SIZE, ERR_FILE_CORRUPT, "The movement set data is too short.");
+	const uint8_t* r = p_data.ptr();
+	ERR_FAIL_COND_V_MSG(decode_uint32(r) != movement_set_magic, ERR_FILE_UNRECOGNIZED, "The data isn't a movement set.");
+	ERR_FAIL_COND_V_MSG(decode_uint32(r + 4) > movement_set_version, ERR_FILE_UNRECOGNIZED, "The movement set was saved by a newer version.");
+	const uint32_t grounded_size = decode_uint32(r + 8);
+	const uint32_t jumping_size = decode_uint32(r + 12);
+	ERR_FAIL_COND_V(grounded_size >= max_state_count || jumping_size >= max_state_count, ERR_FILE_CORRUPT);
+	const uint32_t count = grounded_size + jumping_size;
+	ERR_FAIL_COND_V_MSG((uint32_t)p_data.size() != HEADER_SIZE + count * PROFILE_FIELDS * 4, ERR_FILE_CORRUPT, "The movement set data doesn't match its profile count.");
+
+	LocalVector<Profile> profiles;
+	profiles.resize(count);
+	r += HEADER_SIZE;
+	for (uint32_t i = 0; i < count; ++i) {
+		Profile& profile = profiles[i];
+		real_t* fields[PROFILE_FIELDS] = { &profile.speed, &profile.acceleration, &profile.max_speed, &profile.min_speed, &profile.scale_inherited_speed,
+			&profile.jump_height, &profile.jump_duration, &profile.xVel_to_yVel_ratio, &profile.scale_inherited_ySpeed };
+		for (uint32_t j = 0; j < PROFILE_FIELDS; ++j, r += 4)
+			*fields[j] = decode_float(r);
+	}
+	_materialize(profiles, grounded_size);
+	emit_changed();
+	return OK;
+}
+// the profiles are read back from the shared movement data, edits made through it are saved
+PackedByteArray MovementSet::get_data() const {
+	const uint32_t count = grounded_count + jumping.size();
+	PackedByteArray data;
+	data.resize(HEADER_SIZE + count * PROFILE_FIELDS * 4);
+	uint8_t* w = data.ptrw();
+	encode_uint32(movement_set_magic, w);
+	encode_uint32(movement_set_version, w + 4);
+	encode_uint32(grounded_count, w + 8);
+	encode_uint32(jumping.size(), w + 12);
+	w += HEADER_SIZE;
+	for (uint32_t i = 0; i < count; ++i) {
+		const Profile profile = get_profile(i);
+		const real_t fields[PROFILE_FIELDS] = { profile.speed, profile.acceleration, profile.max_speed, profile.min_speed, profile.scale_inherited_speed,
+			profile.jump_height, profile.jump_duration, profile.xVel_to_yVel_ratio, profile.scale_inherited_ySpeed };
+		for (uint32_t j = 0; j < PROFILE_FIELDS; ++j, w += 4)
+			encode_float(fields[j], w);
+	}
+	return data;
+}
+void MovementSet::_set_data(const PackedByteArray& p_data) {
+	set_data(p_data);
+}
+
+
+// the whole bank is read in one go, no sub resources to resolve
+Ref<Resource> ResourceFormatLoaderMovementSet::load(const String& p_path, const String& p_original_path, Error* r_error, bool p_use_sub_threads, float* r_progress, CacheMode p_cache_mode) {
+	Error err = OK;
+	const Vector<uint8_t> bytes = FileAccess::get_file_as_bytes(p_path, &err);
+	if (r_error)
+		*r_error = err;
+	ERR_FAIL_COND_V_MSG(err != OK, Ref<Resource>(), "Can't open movement set file '" + p_path + "'.");
+
+	Ref<MovementSet> set;
+	set.instantiate();
+	err = set->set_data(bytes);
+	if (r_error)
+		*r_error = err;
+	ERR_FAIL_COND_V_MSG(err != OK, Ref<Resource>(), "Can't load movement set file '" + p_path + "'.");
+	return set;
+}
+void ResourceFormatLoaderMovementSet::get_recognized_extensions(List<String>* p_extensions) const {
+	p_extensions->push_back("mvset");
+}
+bool ResourceFormatLoaderMovementSet::handles_type(const String& p_type) const {
+	return ClassDB::is_parent_class("MovementSet", p_type);
+}
+String ResourceFormatLoaderMovementSet::get_resource_type(const String& p_path) const {
+	return (p_path.get_extension().to_lower() == "mvset" ? "MovementSet" : "");
+}
+
+Error ResourceFormatSaverMovementSet::save(const Ref<Resource>& p_resource, const String& p_path, uint32_t p_flags) {
+	const Ref<MovementSet> set = p_resource;
+	ERR_FAIL_COND_V(set.is_null(), ERR_INVALID_PARAMETER);
+	Error err = OK;
+	Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(err != OK, err, "Can't save movement set file '" + p_path + "'.");
+	const PackedByteArray data = set->get_data();
+	file->store_buffer(data.ptr(), data.size());
+	return (file->get_error() != OK && file->get_error() != ERR_FILE_EOF ? ERR_CANT_CREATE : OK);
+}
+bool ResourceFormatSaverMovementSet::recognize(const Ref<Resource>& p_resource) const {
+	return Object::cast_to<MovementSet>(*p_resource) != nullptr;
+}
+void ResourceFormatSaverMovementSet::get_recognized_extensions(const Ref<Resource>& p_resource, List<String>* p_extensions) const {
+	if (recognize(p_resource))
+		p_extensions->push_back("mvset");
+}
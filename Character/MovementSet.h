@@ -0,0 +1,79 @@
+#ifndef MOVEMENT_SET
+#define MOVEMENT_SET
+
+#include "core/io/resource.h"
+#include "core/io/resource_loader.h"
+#include "core/io/resource_saver.h"
+#include "core/templates/local_vector.h"
+#include "GroundedMovementData1D.h"
+#include "MovementData2D.h"
+
+// Grounded and jumping movement of a character kind, shared by every character using it.
+// A .mvset bank file holds the profiles as one flat block, loading it builds the movement data characters integrate with.
+// That movement data is shared: editing one from a script or the inspector changes it for every character of the set,
+// and get_data and the saver read the profiles back from it.
+class MovementSet : public Resource {
+	GDCLASS(MovementSet, Resource);
+	OBJ_SAVE_TYPE(MovementSet);
+
+public:
+	struct Profile {
+		real_t speed = 0;
+		real_t acceleration = 0;
+		real_t max_speed = 0;
+		real_t min_speed = 0;
+		real_t scale_inherited_speed = 0;
+		// zero for grounded profiles, gravity and the jump velocity follow from height and duration
+		real_t jump_height = 0;
+		real_t jump_duration = 0;
+		real_t xVel_to_yVel_ratio = 0;
+		real_t scale_inherited_ySpeed = 0;
+	};
+	static const uint32_t PROFILE_FIELDS = 9;
+	static const uint32_t HEADER_SIZE = 16; // magic, version, grounded count, jumping count
+
+private:
+	uint32_t grounded_count = 0;
+
+	// built once from the profiles, characters share these vectors instead of copying their lists
+	Vector<Ref<GroundedMovementData1D>> grounded;
+	Vector<Ref<MovementData2D>> jumping;
+
+	static void _read_profile(const GroundedMovementData1D* p_data, Profile& r_profile);
+	static void _read_profile(const MovementData2D* p_data, Profile& r_profile);
+	void _materialize(const LocalVector<Profile>& p_profiles, const uint32_t p_grounded_count);
+
+protected:
+	static void _bind_methods();
+public:
+	void build(const Array& p_grounded, const Array& p_jumping);
+
+	int get_grounded_count() const;
+	int get_jumping_count() const;
+	Profile get_profile(const int p_index) const; // jumping profiles follow the grounded ones, read from the shared movement data
+	_FORCE_INLINE_ const Vector<Ref<GroundedMovementData1D>>& get_grounded() const { return grounded; }
+	_FORCE_INLINE_ const Vector<Ref<MovementData2D>>& get_jumping() const { return jumping; }
+	Array get_grounded_movement_data() const;
+	Array get_jumping_movement_data() const;
+
+	Error set_data(const PackedByteArray& p_data);
+	PackedByteArray get_data() const;
+	void _set_data(const PackedByteArray& p_data);
+};
+
+class ResourceFormatLoaderMovementSet : public ResourceFormatLoader {
+public:
+	virtual Ref<Resource> load(const String& p_path, const String& p_original_path = "", Error* r_error = nullptr, bool p_use_sub_threads = false, float* r_progress = nullptr, CacheMode p_cache_mode = CACHE_MODE_REUSE) override;
+	virtual void get_recognized_extensions(List<String>* p_extensions) const override;
+	virtual bool handles_type(const String& p_type) const override;
+	virtual String get_resource_type(const String& p_path) const override;
+};
+
+class ResourceFormatSaverMovementSet : public ResourceFormatSaver {
+public:
+	virtual Error save(const Ref<Resource>& p_resource, const String& p_path, uint32_t p_flags = 0) override;
+	virtual bool recognize(const Ref<Resource>& p_resource) const override;
+	virtual void get_recognized_extensions(const Ref<Resource>& p_resource, List<String>* p_extensions) const override;
+};
+
+#endif
@@ -0,0 +1,134 @@
+#include "TileOccupancyGrid2D.h"
+
+#include "scene/2d/tile_map.h"
+
+static const real_t sweep_epsilon = 0.001; // a box resting on a cell edge touches it without overlapping it
+
+void TileOccupancyGrid2D::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("setup", "origin", "cell_size", "bounds"), &TileOccupancyGrid2D::setup);
+	ClassDB::bind_method(D_METHOD("bake_tile_map", "tile_map", "layer"), &TileOccupancyGrid2D::bake_tile_map);
+	ClassDB::bind_method(D_METHOD("fill_rect", "rect", "solid"), &TileOccupancyGrid2D::fill_rect);
+
+	ClassDB::bind_method(D_METHOD("set_cell_solid", "cell", "solid"), &TileOccupancyGrid2D::set_cell_solid);
+	ClassDB::bind_method(D_METHOD("is_cell_solid", "cell"), &TileOccupancyGrid2D::is_cell_solid);
+	ClassDB::bind_method(D_METHOD("get_cell_at", "position"), &TileOccupancyGrid2D::get_cell_at);
+	ClassDB::bind_method(D_METHOD("get_origin"), &TileOccupancyGrid2D::get_origin);
+	ClassDB::bind_method(D_METHOD("get_cell_size"), &TileOccupancyGrid2D::get_cell_size);
+	ClassDB::bind_method(D_METHOD("get_bounds"), &TileOccupancyGrid2D::get_bounds);
+
+	ClassDB::bind_method(D_METHOD("_set_origin", "origin"), &TileOccupancyGrid2D::_set_origin);
+	ClassDB::bind_method(D_METHOD("_set_cell_size", "cell_size"), &TileOccupancyGrid2D::_set_cell_size);
+	ClassDB::bind_method(D_METHOD("_set_bounds", "bounds"), &TileOccupancyGrid2D::_set_bounds);
+	ClassDB::bind_method(D_METHOD("_set_cells", "cells"), &TileOccupancyGrid2D::_set_cells);
+	ClassDB::bind_method(D_METHOD("_get_cells"), &TileOccupancyGrid2D::_get_cells);
+
+	ADD_PROPERTY(PropertyInfo(Variant::VECTOR2, "origin", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR), "_set_origin", "get_origin");
+	ADD_PROPERTY(PropertyInfo(Variant::VECTOR2, "cell_size", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR), "_set_cell_size", "get_cell_size");
+	ADD_PROPERTY(PropertyInfo(Variant::RECT2I, "bounds", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR), "_set_bounds", "get_bounds");
+	ADD_PROPERTY(PropertyInfo(Variant::PACKED_BYTE_ARRAY, "cells", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR), "_set_cells", "_get_cells");
+}
+
+void TileOccupancyGrid2D::setup(const Vector2 p_origin, const Vector2 p_cell_size, const Rect2i p_bounds) {
+	ERR_FAIL_COND(p_cell_size.x <= 0 || p_cell_size.y <= 0);
+	ERR_FAIL_COND(p_bounds.size.x < 0 || p_bounds.size.y < 0);
+	origin = p_origin;
+	cell_size = p_cell_size;
+	bounds = p_bounds;
+	cells.resize(bounds.size.x * bounds.size.y);
+	cells.fill(0);
+}
+
+// every used cell is solid, the tile map is expected to be neither rotated nor scaled
+void TileOccupancyGrid2D::bake_tile_map(Node* p_tile_map, const int p_layer) {
+	const TileMap* tile_map = Object::cast_to<TileMap>(p_tile_map);
+	ERR_FAIL_NULL(tile_map);
+	ERR_FAIL_COND(tile_map->get_tileset().is_null());
+
+	const TypedArray<Vector2i> used = tile_map->get_used_cells(p_layer);
+	Rect2i used_bounds;
+	for (int i = 0; i < used.size(); ++i) {
+		const Vector2i cell = used[i];
+		used_bounds = (i ? used_bounds.expand(cell) : Rect2i(cell, Size2i()));
+	}
+	used_bounds.size += Size2i(1, 1);
+	const Vector2 tile_size = tile_map->get_tileset()->get_tile_size();
+	const Vector2 corner = tile_map->get_global_transform().xform(tile_map->map_to_local(Vector2i()) - tile_size * 0.5);
+	setup(corner, tile_size, used.size() ? used_bounds : Rect2i());
+	for (int i = 0; i < used.size(); ++i)
+		set_cell_solid(used[i], true);
+}
+
+void TileOccupancyGrid2D::fill_rect(const Rect2 p_rect, const bool p_solid) {
+	const Vector2i from = get_cell_at(p_rect.position + Vector2(sweep_epsilon, sweep_epsilon));
+	const Vector2i to = get_cell_at(p_rect.get_end() - Vector2(sweep_epsilon, sweep_epsilon));
+	for (int y = from.y; y <= to.y; ++y) {
+		for (int x = from.x; x <= to.x; ++x)
+			set_cell_solid(Vector2i(x, y), p_solid);
+	}
+}
+
+void TileOccupancyGrid2D::set_cell_solid(const Vector2i p_cell, const bool p_solid) {
+	ERR_FAIL_COND_MSG(!bounds.has_point(p_cell), "The cell is outside the bounds of the grid.");
+	cells.write[(p_cell.y - bounds.position.y) * bounds.size.x + (p_cell.x - bounds.position.x)] = p_solid;
+}
+bool TileOccupancyGrid2D::is_cell_solid(const Vector2i p_cell) const {
+	return _is_solid(p_cell.x, p_cell.y);
+}
+Vector2i TileOccupancyGrid2D::get_cell_at(const Vector2 p_position) const {
+	return Vector2i(Math::floor((p_position.x - origin.x) / cell_size.x), Math::floor((p_position.y - origin.y) / cell_size.y));
+}
+
+// Cells are crossed in the order the leading edge reaches them, the first line holding a solid cell stops the box.
+real_t TileOccupancyGrid2D::sweep(const Rect2& p_box, const Vector2::Axis p_axis, const real_t p_motion) const {
+	if (p_motion == 0)
+		return 0;
+	const Vector2::Axis cross = (p_axis == Vector2::AXIS_X ? Vector2::AXIS_Y : Vector2::AXIS_X);
+	const real_t size = cell_size[p_axis];
+	const real_t offset = origin[p_axis];
+	// cells the box spans across the motion, touching edges excluded
+	const int cross_from = Math::floor((p_box.position[cross] + sweep_epsilon - origin[cross]) / cell_size[cross]);
+	const int cross_to = Math::floor((p_box.get_end()[cross] - sweep_epsilon - origin[cross]) / cell_size[cross]);
+	const bool forward = p_motion > 0;
+	const real_t edge = (forward ? p_box.get_end()[p_axis] : p_box.position[p_axis]);
+	// a cell the leading edge already overlaps is ignored in either direction, so a box stuck in a wall can leave it
+	const int from = (forward ? int(Math::floor((edge - sweep_epsilon - offset) / size)) + 1 : int(Math::floor((edge + sweep_epsilon - offset) / size)) - 1);
+	const int to = Math::floor((edge + p_motion - offset) / size);
+	const int step = (forward ? 1 : -1);
+	for (int line = from; forward ? line <= to : line >= to; line += step) {
+		for (int i = cross_from; i <= cross_to; ++i) {
+			if (!(p_axis == Vector2::AXIS_X ? _is_solid(line, i) : _is_solid(i, line)))
+				continue;
+			const real_t limit = offset + (forward ? line : line + 1) * size - edge;
+			return (forward ? CLAMP(limit, (real_t)0, p_motion) : CLAMP(limit, p_motion, (real_t)0));
+		}
+	}
+	return p_motion;
+}
+
+Vector2 TileOccupancyGrid2D::get_origin() const {
+	return origin;
+}
+Vector2 TileOccupancyGrid2D::get_cell_size() const {
+	return cell_size;
+}
+Rect2i TileOccupancyGrid2D::get_bounds() const {
+	return bounds;
+}
+
+void TileOccupancyGrid2D::_set_origin(const Vector2 p_origin) {
+	origin = p_origin;
+}
+void TileOccupancyGrid2D::_set_cell_size(const Vector2 p_cell_size) {
+	ERR_FAIL_COND(p_cell_size.x <= 0 || p_cell_size.y <= 0);
+	cell_size = p_cell_size;
+}
+void TileOccupancyGrid2D::_set_bounds(const Rect2i p_bounds) {
+	bounds = p_bounds;
+}
+void TileOccupancyGrid2D::_set_cells(const PackedByteArray& p_cells) {
+	ERR_FAIL_COND_MSG(p_cells.size() != bounds.size.x * bounds.size.y, "The cells don't match the bounds of the grid.");
+	cells = p_cells;
+}
+PackedByteArray TileOccupancyGrid2D::_get_cells() const {
+	return cells;
+}
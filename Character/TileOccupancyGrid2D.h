@@ -0,0 +1,47 @@
+#ifndef TILE_OCCUPANCY_GRID_2D
+#define TILE_OCCUPANCY_GRID_2D
+
+#include "core/io/resource.h"
+
+// Solid cells of a static level, kinematic characters sweep their box against it instead of the physics server.
+class TileOccupancyGrid2D : public Resource {
+	GDCLASS(TileOccupancyGrid2D, Resource);
+	OBJ_SAVE_TYPE(TileOccupancyGrid2D);
+
+	Vector2 origin = Vector2(); // global position of the top left corner of cell (0, 0)
+	Vector2 cell_size = Vector2(16, 16);
+	Rect2i bounds = Rect2i(); // in cells, everything outside is empty
+	PackedByteArray cells; // one byte per cell of bounds, row by row
+
+	_FORCE_INLINE_ bool _is_solid(const int p_x, const int p_y) const {
+		const int x = p_x - bounds.position.x;
+		const int y = p_y - bounds.position.y;
+		if (x < 0 || y < 0 || x >= bounds.size.x || y >= bounds.size.y)
+			return false;
+		return cells.ptr()[y * bounds.size.x + x];
+	}
+
+protected:
+	static void _bind_methods();
+public:
+	void setup(const Vector2 p_origin, const Vector2 p_cell_size, const Rect2i p_bounds);
+	void bake_tile_map(Node* p_tile_map, const int p_layer);
+	void fill_rect(const Rect2 p_rect, const bool p_solid); // every cell the rect overlaps
+
+	void set_cell_solid(const Vector2i p_cell, const bool p_solid);
+	bool is_cell_solid(const Vector2i p_cell) const;
+	Vector2i get_cell_at(const Vector2 p_position) const;
+	Vector2 get_origin() const;
+	Vector2 get_cell_size() const;
+	Rect2i get_bounds() const;
+
+	real_t sweep(const Rect2& p_box, const Vector2::Axis p_axis, const real_t p_motion) const; // how far the box moves along the axis before touching a solid cell
+
+	void _set_origin(const Vector2 p_origin);
+	void _set_cell_size(const Vector2 p_cell_size);
+	void _set_bounds(const Rect2i p_bounds);
+	void _set_cells(const PackedByteArray& p_cells);
+	PackedByteArray _get_cells() const;
+};
+
+#endif
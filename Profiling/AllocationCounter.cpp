@@ -0,0 +1,61 @@
+#include "AllocationCounter.h"
+
+#ifdef MARTHVON_BENCHMARK
+
+#include "core/error/error_macros.h"
+#include "core/os/thread.h"
+
+#include <atomic>
+
+thread_local uint64_t AllocationCounter::thread_count = 0;
+static std::atomic<uint64_t> scope_count{ 0 }; // what scopes on other threads counted
+
+#ifdef MARTHVON_ALLOCATION_HOOK
+// SCsub links with --wrap for these symbols, the engine keeps calling them unchanged.
+void* real_alloc_static(size_t p_bytes, bool p_pad_align) __asm__("__real__ZN6Memory12alloc_staticEmb");
+void* real_realloc_static(void* p_memory, size_t p_bytes, bool p_pad_align) __asm__("__real__ZN6Memory14realloc_staticEPvmb");
+void* real_new(size_t p_size, const char* p_description) __asm__("__real__ZnwmPKc");
+
+void* wrap_alloc_static(size_t p_bytes, bool p_pad_align) __asm__("__wrap__ZN6Memory12alloc_staticEmb");
+void* wrap_realloc_static(void* p_memory, size_t p_bytes, bool p_pad_align) __asm__("__wrap__ZN6Memory14realloc_staticEPvmb");
+void* wrap_new(size_t p_size, const char* p_description) __asm__("__wrap__ZnwmPKc");
+
+void* wrap_alloc_static(size_t p_bytes, bool p_pad_align) {
+	AllocationCounter::_count();
+	return real_alloc_static(p_bytes, p_pad_align);
+}
+void* wrap_realloc_static(void* p_memory, size_t p_bytes, bool p_pad_align) {
+	AllocationCounter::_count();
+	return real_realloc_static(p_memory, p_bytes, p_pad_align);
+}
+// memnew calls alloc_static from inside memory.cpp, where the wrap doesn't reach
+void* wrap_new(size_t p_size, const char* p_description) {
+	AllocationCounter::_count();
+	return real_new(p_size, p_description);
+}
+#endif
+
+AllocationCounter::Scope::Scope() :
+		begin(thread_count), active(Thread::get_caller_id() != Thread::get_main_id()) {
+}
+AllocationCounter::Scope::~Scope() {
+	if (active)
+		scope_count.fetch_add(thread_count - begin, std::memory_order_relaxed);
+}
+
+bool AllocationCounter::is_supported() {
+#ifdef MARTHVON_ALLOCATION_HOOK
+	return true;
+#else
+	return false;
+#endif
+}
+
+int64_t AllocationCounter::get_count() {
+	if (!is_supported())
+		return -1;
+	ERR_FAIL_COND_V_MSG(Thread::get_caller_id() != Thread::get_main_id(), -1, "Allocations are read on the main thread.");
+	return thread_count + scope_count.load(std::memory_order_relaxed);
+}
+
+#endif
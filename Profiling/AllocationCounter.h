@@ -0,0 +1,35 @@
+#ifndef MARTHVON_ALLOCATION_COUNTER
+#define MARTHVON_ALLOCATION_COUNTER
+
+#ifdef MARTHVON_BENCHMARK
+
+#include "core/typedefs.h"
+
+// Counts engine allocations, Memory::alloc_static, realloc_static and memnew are wrapped at link time.
+// Each thread counts on its own, only the main thread and threads inside an ALLOCATION_COUNT_SCOPE are reported.
+class AllocationCounter {
+	static thread_local uint64_t thread_count;
+
+public:
+	_FORCE_INLINE_ static void _count() { ++thread_count; }
+
+	struct Scope {
+		uint64_t begin;
+		bool active; // the main thread is always counted
+		Scope();
+		~Scope();
+	};
+
+	static bool is_supported();
+	static int64_t get_count(); // call on the main thread, -1 when allocations can't be counted
+};
+
+#define ALLOCATION_COUNT_SCOPE() AllocationCounter::Scope _allocation_count_scope
+
+#else
+
+#define ALLOCATION_COUNT_SCOPE()
+
+#endif
+
+#endif
@@ -0,0 +1,108 @@
+#include "Tracer.h"
+
+#ifdef MARTHVON_TRACING
+
+#include "core/io/file_access.h"
+#include "core/os/thread.h"
+
+Tracer* Tracer::singleton = nullptr;
+std::atomic<bool> Tracer::enabled = { false };
+std::atomic<Tracer::ThreadBuffer*> Tracer::buffers = { nullptr };
+thread_local Tracer::ThreadBuffer* Tracer::thread_buffer = nullptr;
+
+void Tracer::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("start"), &Tracer::start);
+	ClassDB::bind_method(D_METHOD("stop"), &Tracer::stop);
+	ClassDB::bind_method(D_METHOD("is_tracing"), &Tracer::is_tracing);
+	ClassDB::bind_method(D_METHOD("clear"), &Tracer::clear);
+	ClassDB::bind_method(D_METHOD("dump", "path"), &Tracer::dump);
+}
+
+Tracer* Tracer::get_singleton() {
+	return singleton;
+}
+
+Tracer::ThreadBuffer* Tracer::_create_thread_buffer() {
+	ThreadBuffer* buffer = memnew(ThreadBuffer);
+	buffer->events = memnew_arr(Event, buffer_capacity);
+	buffer->mask = buffer_capacity - 1;
+	buffer->thread_id = Thread::get_caller_id();
+	buffer->next = buffers.load(std::memory_order_relaxed);
+	while (!buffers.compare_exchange_weak(buffer->next, buffer, std::memory_order_release, std::memory_order_relaxed)) {
+	}
+	thread_buffer = buffer;
+	return buffer;
+}
+
+void Tracer::start() {
+	enabled.store(true, std::memory_order_relaxed);
+}
+void Tracer::stop() {
+	enabled.store(false, std::memory_order_relaxed);
+}
+bool Tracer::is_tracing() const {
+	return enabled.load(std::memory_order_relaxed);
+}
+void Tracer::clear() {
+	for (ThreadBuffer* buffer = buffers.load(std::memory_order_acquire); buffer; buffer = buffer->next)
+		buffer->written.store(0, std::memory_order_relaxed);
+}
+
+Error Tracer::dump(const String& p_path) const {
+	Error err;
+	Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(file.is_null(), err, "Can't open trace file: " + p_path);
+	file->store_string("{\"traceEvents\":[");
+	bool first = true;
+	for (const ThreadBuffer* buffer = buffers.load(std::memory_order_acquire); buffer; buffer = buffer->next) {
+		const uint64_t written = buffer->written.load(std::memory_order_acquire);
+		const uint64_t begin = (written > buffer->mask ? written - buffer->mask - 1 : 0);
+		for (uint64_t i = begin; i < written; ++i) {
+			const Event& event = buffer->events[i & buffer->mask];
+			if (!event.name)
+				continue;
+			file->store_string(vformat("%s\n{\"name\":\"%s\",\"ph\":\"%s\",\"ts\":%d,\"pid\":0,\"tid\":%d%s}",
+				first ? "" : ",", event.name, String::chr(event.phase), (int64_t)event.usec, (int64_t)buffer->thread_id,
+				event.phase == PHASE_INSTANT ? ",\"s\":\"t\"" : ""));
+			first = false;
+		}
+	}
+	file->store_string("\n],\"displayTimeUnit\":\"ms\"}\n");
+	return OK;
+}
+
+void Tracer::parse_command_line() {
+	const List<String> args = OS::get_singleton()->get_cmdline_user_args();
+	for (const String& arg : args) {
+		if (arg.begins_with("--marthvon-trace=")) {
+			dump_on_exit_path = arg.get_slice("=", 1);
+			start();
+		}
+	}
+}
+
+void Tracer::dump_on_exit() {
+	if (dump_on_exit_path.is_empty())
+		return;
+	stop();
+	dump(dump_on_exit_path);
+}
+
+Tracer::Tracer() {
+	singleton = this;
+}
+Tracer::~Tracer() {
+	stop();
+	// threads keep their pointer, nothing records once tracing stopped for good
+	ThreadBuffer* buffer = buffers.exchange(nullptr);
+	while (buffer) {
+		ThreadBuffer* next = buffer->next;
+		memdelete_arr(buffer->events);
+		memdelete(buffer);
+		buffer = next;
+	}
+	thread_buffer = nullptr;
+	singleton = nullptr;
+}
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef MARTHVON_TRACER
+#define MARTHVON_TRACER
+
+#ifdef MARTHVON_TRACING
+
+#include "core/object/class_db.h"
+#include "core/os/os.h"
+#include <atomic>
+
+// Begin/end/instant events in a fixed ring buffer per thread, dumped as Chrome/Perfetto trace JSON.
+// Names must be string literals, recording an event never allocates after a thread's first one.
+class Tracer : public Object {
+	GDCLASS(Tracer, Object);
+
+public:
+	enum Phase : char {
+		PHASE_BEGIN = 'B',
+		PHASE_END = 'E',
+		PHASE_INSTANT = 'i'
+	};
+	struct Event {
+		const char* name = nullptr;
+		uint64_t usec = 0;
+		Phase phase = PHASE_INSTANT;
+	};
+	struct ThreadBuffer {
+		Event* events = nullptr;
+		uint32_t mask = 0;
+		std::atomic<uint64_t> written = { 0 }; // only the owning thread writes, a dump reads it with acquire
+		uint64_t thread_id = 0;
+		ThreadBuffer* next = nullptr;
+	};
+
+	struct Scope {
+		const char* name;
+		bool active; // a scope that began records its end, even when tracing stopped in between
+		_FORCE_INLINE_ Scope(const char* p_name) : name(p_name), active(enabled.load(std::memory_order_relaxed)) {
+			if (active)
+				_record(name, PHASE_BEGIN);
+		}
+		_FORCE_INLINE_ ~Scope() {
+			if (active)
+				_record(name, PHASE_END);
+		}
+	};
+
+private:
+	static Tracer* singleton;
+	static std::atomic<bool> enabled;
+	static std::atomic<ThreadBuffer*> buffers; // lock-free list, threads only ever prepend
+	static thread_local ThreadBuffer* thread_buffer;
+	static const uint32_t buffer_capacity = 1 << 16;
+
+	String dump_on_exit_path;
+
+	static ThreadBuffer* _create_thread_buffer();
+
+protected:
+	static void _bind_methods();
+public:
+	_FORCE_INLINE_ static void _record(const char* p_name, const Phase p_phase) {
+		ThreadBuffer* buffer = (thread_buffer ? thread_buffer : _create_thread_buffer());
+		const uint64_t index = buffer->written.load(std::memory_order_relaxed);
+		Event& event = buffer->events[index & buffer->mask];
+		event.name = p_name;
+		event.usec = OS::get_singleton()->get_ticks_usec();
+		event.phase = p_phase;
+		buffer->written.store(index + 1, std::memory_order_release);
+	}
+	_FORCE_INLINE_ static void record(const char* p_name, const Phase p_phase) {
+		if (enabled.load(std::memory_order_relaxed))
+			_record(p_name, p_phase);
+	}
+
+	static Tracer* get_singleton();
+
+	void start();
+	void stop();
+	bool is_tracing() const;
+	void clear(); // call while no thread traces
+	Error dump(const String& p_path) const;
+
+	void parse_command_line(); // --marthvon-trace=<path> after "--" traces from startup and dumps on exit
+	void dump_on_exit();
+
+	Tracer();
+	~Tracer();
+};
+
+#define TRACE_SCOPE(m_name) Tracer::Scope _trace_scope(m_name)
+#define TRACE_INSTANT(m_name) Tracer::record(m_name, Tracer::PHASE_INSTANT)
+
+#else
+
+#define TRACE_SCOPE(m_name)
+#define TRACE_INSTANT(m_name)
+
+#endif
+
+#endif
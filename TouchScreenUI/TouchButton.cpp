@@ -2,17 +2,27 @@
 
 #include "core/input/input_event.h"
 #include "scene/main/window.h"
+#include "TouchInputQueue.h"
+#include "../Profiling/Tracer.h"
 
 void TouchButton::_notification(int p_what) {
     switch(p_what){
 		case NOTIFICATION_PAUSED:
 			_reset();
         break;
+		case NOTIFICATION_INTERNAL_PROCESS:
+			if (release_pending && press_physics_frame != Engine::get_singleton()->get_physics_frames()) {
+				_apply_release();
+				set_process_internal(false);
+			}
+		break;
 		case NOTIFICATION_INTERNAL_PHYSICS_PROCESS:
 			if (get_finger_index() != -1)
 				accum_t += get_physics_process_delta_time();
 		break;
         case NOTIFICATION_DRAW: {
+            const Ref<Texture2D>& normal = _get_profile()->_normal().texture;
+            const Ref<Texture2D>& pressed = _get_profile()->_pressed().texture;
             Color color = Color(1,1,1);
             if(get_finger_index() != -1) {
                 if(pressed.is_valid()) {
@@ -38,6 +48,7 @@ void TouchButton::_notification(int p_what) {
 }
 
 void TouchButton::input(const Ref<InputEvent>& p_event) {
+	TRACE_SCOPE("TouchButton::input");
     ERR_FAIL_COND(p_event.is_null());
 
 	if (!is_visible_in_tree()) {
@@ -47,7 +58,10 @@ void TouchButton::input(const Ref<InputEvent>& p_event) {
 
     if(st) {
 		Point2 coord = get_global_transform_with_canvas().affine_inverse().xform(st->get_position());
+        const real_t radius = _get_profile()->get_button_radius();
         const bool point_is_inside = Control::has_point(coord) && (!radius || (coord - (get_size()/2.0)).length() <= radius );
+		if (st->is_pressed())
+			_record_touch(st->get_position(), coord, point_is_inside);
         if(point_is_inside && get_finger_index() == -1 && st->is_pressed()) {
             _press(st->get_index());
         } else if (get_finger_index() == st->get_index()) {
@@ -57,44 +71,85 @@ void TouchButton::input(const Ref<InputEvent>& p_event) {
 			}
             _release();
         }
+        return;
     }
+
+	const InputEventScreenDrag* const sd = Object::cast_to<InputEventScreenDrag>(*p_event);
+	if (sd && is_analytics())
+		_record_drag(sd->get_position(), get_global_transform_with_canvas().affine_inverse().xform(sd->get_position()), sd->get_index());
 }
 
 void TouchButton::_press(int p_index) {
+	TRACE_SCOPE("TouchButton::_press");
+	if (release_pending)
+		_apply_release();
     _set_finger_index(p_index);
+	press_physics_frame = Engine::get_singleton()->get_physics_frames();
+	if (TouchInputQueue::get_singleton())
+		TouchInputQueue::get_singleton()->push(this, TouchInputTransition::KIND_BUTTON, 1);
     if (action != StringName()) {
 	    Input::get_singleton()->action_press(action);
-		Ref<InputEventAction> iea;
-		iea.instantiate();
-		iea->set_action(action);
-		iea->set_pressed(true);
-		get_viewport()->push_input(iea, true);
+		get_viewport()->push_input(action_pressed_event, true);
 	}
 
-	emit_signal("button_pressed");
+	_push_pressed(true);
+	if (_has_listeners()) {
+		TouchControlEvent event;
+		event.type = TouchControlEvent::EVENT_PRESSED;
+		event.control = this;
+		event.finger = p_index;
+		_notify_listeners(event);
+	}
+	if (_is_signal_connected(SNAME("button_pressed")))
+		emit_signal(SNAME("button_pressed"));
 	queue_redraw();
 }
 
 void TouchButton::_release() {
     _set_finger_index(-1);
+	if (TouchInputQueue::get_singleton())
+		TouchInputQueue::get_singleton()->push(this, TouchInputTransition::KIND_BUTTON, 0);
+	// pressed and released before any physics tick ran, the action stays pressed until one did
+	if (press_physics_frame == Engine::get_singleton()->get_physics_frames()) {
+		release_pending = true;
+		set_process_internal(true);
+		queue_redraw();
+		return;
+	}
+	_apply_release();
+}
+
+void TouchButton::_apply_release() {
+	TRACE_SCOPE("TouchButton::_apply_release");
+	release_pending = false;
     if (action != StringName()) {
 	    Input::get_singleton()->action_release(action);
-	    Ref<InputEventAction> iea;
-	    iea.instantiate();
-	    iea->set_action(action);
-	    iea->set_pressed(false);
-		get_viewport()->push_input(iea, true);
+		get_viewport()->push_input(action_released_event, true);
 	}
 
-    emit_signal("button_released");
+	_push_pressed(false);
+	if (_has_listeners()) {
+		TouchControlEvent event;
+		event.type = TouchControlEvent::EVENT_RELEASED;
+		event.control = this;
+		event.held_time = accum_t;
+		_notify_listeners(event);
+	}
+	if (_is_signal_connected(SNAME("button_released")))
+		emit_signal(SNAME("button_released"));
 	if (isAccumulate) {
-		emit_signal("button_released_with_time_accum", accum_t);
+		if (_is_signal_connected(SNAME("button_released_with_time_accum")))
+			emit_signal(SNAME("button_released_with_time_accum"), accum_t);
 		accum_t = 0;
 	}
 	queue_redraw();
 }
 
 void TouchButton::_reset() {
+	if (release_pending)
+		_apply_release();
+	if (get_finger_index() != -1)
+		_push_pressed(false);
 	_set_finger_index(-1);
 	accum_t = 0;
 	queue_redraw();
@@ -127,6 +182,7 @@ void TouchButton::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("get_held_time"), &TouchButton::get_held_time);
 	ClassDB::bind_method(D_METHOD("is_held"), &TouchButton::is_held);
+	ClassDB::bind_method(D_METHOD("get_pressed_plug"), &TouchButton::get_pressed_plug);
 
     ADD_SIGNAL(MethodInfo("button_pressed"));
     ADD_SIGNAL(MethodInfo("button_released"));
@@ -135,27 +191,39 @@ void TouchButton::_bind_methods() {
 
 void TouchButton::set_action(const StringName p_name) {
     action = p_name;
+	if (action == StringName()) {
+		action_pressed_event.unref();
+		action_released_event.unref();
+		return;
+	}
+	if (action_pressed_event.is_null()) {
+		action_pressed_event.instantiate();
+		action_pressed_event->set_pressed(true);
+		action_released_event.instantiate();
+	}
+	action_pressed_event->set_action(action);
+	action_released_event->set_action(action);
 }
 StringName TouchButton::get_action() const {
     return action;
 }
 void TouchButton::set_texture(const Ref<Texture2D> p_texture){
-    normal = p_texture;
+    _get_profile()->set_normal_texture(p_texture);
 }
 Ref<Texture2D> TouchButton::get_texture() const{
-    return normal;
+    return _get_profile()->get_normal_texture();
 }
 void TouchButton::set_pressed_texture(const Ref<Texture2D> p_texture){
-    pressed = p_texture;
+    _get_profile()->set_pressed_texture(p_texture);
 }
 Ref<Texture2D> TouchButton::get_pressed_texture() const {
-    return pressed;
+    return _get_profile()->get_pressed_texture();
 }
 void TouchButton::set_radius(const real_t p_radius){
-    radius = p_radius;
+    _get_profile()->set_button_radius(p_radius);
 }
 real_t TouchButton::get_radius() const{
-    return radius;
+    return _get_profile()->get_button_radius();
 }
 void TouchButton::toggle_accumulate_time(const bool p_accumulate){
     isAccumulate = p_accumulate;
@@ -177,3 +245,17 @@ real_t TouchButton::get_held_time() const {
 bool TouchButton::is_held() const{
     return isHeld;
 }
+Ref<OutputPlug> TouchButton::get_pressed_plug() {
+	if (pressed_plug.is_null()) {
+		pressed_plug.instantiate();
+		pressed_plug->setup(OutputPlug::TYPE_BOOL, 16);
+	}
+	return pressed_plug;
+}
+void TouchButton::_push_pressed(const bool p_pressed) {
+	if (pressed_plug.is_null())
+		return;
+	PlugSample sample;
+	sample.boolean = p_pressed;
+	pressed_plug->push(sample);
+}
@@ -2,7 +2,9 @@
 #define TOUCH_SCREEN_BUTTON
 
 #include "core/object/ref_counted.h"
+#include "core/input/input_event.h"
 #include "TouchControl.h"
+#include "../Bitwise/StreamGraph.h"
 #include "scene/resources/texture.h"
 #include "scene/resources/circle_shape_2d.h"
 
@@ -10,14 +12,19 @@ class TouchButton : public TouchControl {
 	GDCLASS(TouchButton, TouchControl);
 
 	StringName action = "";
-	real_t radius = 0.0;
-	real_t accum_t = 0.0;
-	Ref<Texture2D> normal;
-	Ref<Texture2D> pressed;
+	Ref<InputEventAction> action_pressed_event; // pushed on every press and release, built once per action
+	Ref<InputEventAction> action_released_event;
+	real_t accum_t = 0.0; // textures and radius are the normal, pressed and button ones of the profile
 
 	bool signal_only_when_released_inside = true;
 	bool isAccumulate = false;
 	bool isHeld = false;
+
+	uint64_t press_physics_frame = 0;
+	bool release_pending = false;
+
+	Ref<OutputPlug> pressed_plug; // created once asked for
+	void _push_pressed(const bool p_pressed);
 protected:
 	void _notification(int p_what);
 	static void _bind_methods();
@@ -42,10 +49,12 @@ public:
 
 	real_t get_held_time() const;
 	bool is_held() const;
+	Ref<OutputPlug> get_pressed_plug();
 private:
 	virtual void input(const Ref<InputEvent>& p_event) override;
 	void _press(int p_index);
 	void _release();
+	void _apply_release();
 	void _reset();
 };
 
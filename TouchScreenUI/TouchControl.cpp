@@ -1,11 +1,78 @@
 #include "TouchControl.h"
 
+#include "core/config/engine.h"
+#include "core/core_string_names.h"
+#include "core/version.h"
+
+static const int heatmap_cells = 32; // per side of a control
+static const int screen_heatmap_cells = 64; // per side of the screen, whatever its aspect
+static const real_t heatmap_margin = 0.25; // of the size of the control, touches there count as misses
+
+TouchHeatmap TouchControl::screen_heatmap;
+ObjectID TouchControl::screen_heatmap_feeder;
+TouchControl::ScreenTouch TouchControl::screen_touch;
+
 void TouchControl::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_finger_index"), &TouchControl::get_finger_index);
 	ClassDB::bind_method(D_METHOD("is_passby_press"), &TouchControl::is_passby_press);
 	ClassDB::bind_method(D_METHOD("set_passby_press", "passby_press"), &TouchControl::set_passby_press);
 	
+	ClassDB::bind_method(D_METHOD("set_profile", "profile"), &TouchControl::set_profile);
+	ClassDB::bind_method(D_METHOD("get_profile"), &TouchControl::get_profile);
+
+	ClassDB::bind_method(D_METHOD("toggle_analytics", "enable"), &TouchControl::toggle_analytics);
+	ClassDB::bind_method(D_METHOD("is_analytics"), &TouchControl::is_analytics);
+	ClassDB::bind_method(D_METHOD("get_heatmap", "layer"), &TouchControl::get_heatmap);
+	ClassDB::bind_method(D_METHOD("get_heatmap_image", "layer"), &TouchControl::get_heatmap_image);
+	ClassDB::bind_method(D_METHOD("get_heatmap_size"), &TouchControl::get_heatmap_size);
+	ClassDB::bind_method(D_METHOD("clear_heatmap"), &TouchControl::clear_heatmap);
+	ClassDB::bind_static_method("TouchControl", D_METHOD("get_screen_heatmap", "layer"), &TouchControl::get_screen_heatmap);
+	ClassDB::bind_static_method("TouchControl", D_METHOD("get_screen_heatmap_image", "layer"), &TouchControl::get_screen_heatmap_image);
+	ClassDB::bind_static_method("TouchControl", D_METHOD("get_screen_heatmap_size"), &TouchControl::get_screen_heatmap_size);
+	ClassDB::bind_static_method("TouchControl", D_METHOD("clear_screen_heatmap"), &TouchControl::clear_screen_heatmap);
+
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "passby press"), "set_passby_press", "is_passby_press");
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "profile", PROPERTY_HINT_RESOURCE_TYPE, "TouchControlProfile"), "set_profile", "get_profile");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "analytics"), "toggle_analytics", "is_analytics");
+
+	BIND_ENUM_CONSTANT(HEATMAP_PRESSES);
+	BIND_ENUM_CONSTANT(HEATMAP_MISSES);
+	BIND_ENUM_CONSTANT(HEATMAP_DRAGS);
+}
+
+void TouchControl::_notification(int p_what) {
+	switch (p_what) {
+		case NOTIFICATION_ENTER_TREE:
+			profile->connect(CoreStringNames::get_singleton()->changed, callable_mp(this, &TouchControl::_on_profile_changed));
+			_profile_changed();
+		break;
+		case NOTIFICATION_EXIT_TREE:
+			profile->disconnect(CoreStringNames::get_singleton()->changed, callable_mp(this, &TouchControl::_on_profile_changed));
+		break;
+	}
+}
+
+// the skin and tuning of a shared profile are saved with the profile, not with every control
+void TouchControl::_validate_property(PropertyInfo& p_property) const {
+	static const char* profile_properties[] = { "normal_texture", "normal_scale", "pressed_texture", "pressed_scale", "stick_texture", "stick_scale",
+		"texture", "texture scale", "pressed", "radius", "show mode", "deadzone extent", "direction span" };
+	if (!profile_shared)
+		return;
+	for (const char* name : profile_properties) {
+		if (p_property.name == name) {
+			p_property.usage = PROPERTY_USAGE_NONE;
+			return;
+		}
+	}
+}
+
+void TouchControl::_on_profile_changed() {
+	_profile_changed();
+}
+
+void TouchControl::_profile_changed() {
+	update_minimum_size();
+	queue_redraw();
 }
 
 void TouchControl::_set_finger_index(int p_finger_pressed) {
@@ -23,3 +90,156 @@ bool TouchControl::is_passby_press() const {
 void TouchControl::set_passby_press(bool p_passby_press) {
 	passby_press = p_passby_press;
 }
+
+void TouchControl::add_listener(TouchControlListener* p_listener) {
+	ERR_FAIL_NULL(p_listener);
+	ERR_FAIL_COND(listeners.find(p_listener) >= 0);
+	listeners.push_back(p_listener);
+}
+
+void TouchControl::remove_listener(TouchControlListener* p_listener) {
+	listeners.erase(p_listener);
+}
+
+void TouchControl::_notify_listeners(const TouchControlEvent& p_event) const {
+	for (uint32_t i = 0; i < listeners.size(); ++i)
+		listeners[i]->_touch_control_event(p_event);
+}
+
+// asked on every event and tick, it must not allocate
+bool TouchControl::_is_signal_connected(const StringName& p_signal) const {
+#if VERSION_MAJOR > 4 || (VERSION_MAJOR == 4 && VERSION_MINOR >= 2)
+	return has_connections(p_signal);
+#else
+	List<Connection> connections; // engines before has_connections only have the list, it allocates while connected
+	get_signal_connection_list(p_signal, &connections);
+	return !connections.is_empty();
+#endif
+}
+
+void TouchControl::set_profile(const Ref<TouchControlProfile>& p_profile) {
+	if (p_profile.is_valid() ? p_profile == profile : !profile_shared)
+		return;
+	if (is_inside_tree())
+		profile->disconnect(CoreStringNames::get_singleton()->changed, callable_mp(this, &TouchControl::_on_profile_changed));
+	profile_shared = p_profile.is_valid();
+	// a control leaving a shared profile keeps its look in a local copy
+	profile = (profile_shared ? p_profile : Ref<TouchControlProfile>(profile->duplicate()));
+	if (is_inside_tree())
+		profile->connect(CoreStringNames::get_singleton()->changed, callable_mp(this, &TouchControl::_on_profile_changed));
+	_profile_changed();
+	notify_property_list_changed();
+}
+
+Ref<TouchControlProfile> TouchControl::get_profile() const {
+	return (profile_shared ? profile : Ref<TouchControlProfile>());
+}
+
+// the feeder is handed over once it stops getting touches
+bool TouchControl::_is_screen_heatmap_feeder() {
+	if (screen_heatmap_feeder == get_instance_id())
+		return true;
+	const TouchControl* feeder = Object::cast_to<TouchControl>(ObjectDB::get_instance(screen_heatmap_feeder));
+	if (feeder && feeder->heatmap && feeder->is_visible_in_tree() && feeder->is_processing_input())
+		return false;
+	screen_heatmap_feeder = get_instance_id();
+	return true;
+}
+
+void TouchControl::_accumulate_touch(const Point2 p_screen_position, const Point2 p_local_position, const bool p_hit) {
+	const Point2 point = (p_local_position / get_size() + Vector2(heatmap_margin, heatmap_margin)) / (1.0 + 2.0 * heatmap_margin);
+	const Point2 screen_point = p_screen_position / get_viewport_rect().size;
+	heatmap->add(p_hit ? TouchHeatmap::LAYER_PRESSES : TouchHeatmap::LAYER_MISSES, point);
+	// every control sees the same event within a frame, a different one means the last was seen by all of them
+	const uint64_t frame = Engine::get_singleton()->get_process_frames();
+	if (!screen_touch.open || screen_touch.frame != frame || screen_touch.point != screen_point) {
+		_commit_screen_touch();
+		screen_touch.point = screen_point;
+		screen_touch.frame = frame;
+		screen_touch.near = screen_touch.hit = false;
+		screen_touch.open = true;
+	}
+	screen_touch.hit |= p_hit;
+	screen_touch.near |= (!p_hit && point.x >= 0 && point.y >= 0 && point.x < 1 && point.y < 1);
+	if (_is_screen_heatmap_feeder())
+		screen_heatmap.add(TouchHeatmap::LAYER_PRESSES, screen_point);
+}
+
+// a touch down that hit no control but landed next to one is a single screen miss
+void TouchControl::_commit_screen_touch() {
+	if (screen_touch.open && screen_touch.near && !screen_touch.hit)
+		screen_heatmap.add(TouchHeatmap::LAYER_MISSES, screen_touch.point);
+	screen_touch.open = false;
+}
+
+void TouchControl::_accumulate_drag(const Point2 p_screen_position, const Point2 p_local_position, const bool p_held) {
+	if (p_held)
+		heatmap->add(TouchHeatmap::LAYER_DRAGS, (p_local_position / get_size() + Vector2(heatmap_margin, heatmap_margin)) / (1.0 + 2.0 * heatmap_margin));
+	if (_is_screen_heatmap_feeder())
+		screen_heatmap.add(TouchHeatmap::LAYER_DRAGS, p_screen_position / get_viewport_rect().size);
+}
+
+void TouchControl::toggle_analytics(const bool p_enable) {
+	if (p_enable == (heatmap != nullptr))
+		return;
+	if (p_enable) {
+		heatmap = new TouchHeatmap();
+		heatmap->setup(heatmap_cells, heatmap_cells);
+		if (!screen_heatmap.is_setup())
+			screen_heatmap.setup(screen_heatmap_cells, screen_heatmap_cells);
+	} else {
+		delete heatmap;
+		heatmap = nullptr;
+	}
+}
+
+bool TouchControl::is_analytics() const {
+	return heatmap != nullptr;
+}
+
+PackedInt32Array TouchControl::get_heatmap(const HeatmapLayer p_layer) const {
+	ERR_FAIL_NULL_V_MSG(heatmap, PackedInt32Array(), "Analytics is off.");
+	return heatmap->get_layer(TouchHeatmap::Layer(p_layer));
+}
+
+Ref<Image> TouchControl::get_heatmap_image(const HeatmapLayer p_layer) const {
+	ERR_FAIL_NULL_V_MSG(heatmap, Ref<Image>(), "Analytics is off.");
+	return heatmap->get_layer_image(TouchHeatmap::Layer(p_layer));
+}
+
+Vector2i TouchControl::get_heatmap_size() const {
+	return Vector2i(heatmap_cells, heatmap_cells);
+}
+
+void TouchControl::clear_heatmap() {
+	if (heatmap)
+		heatmap->clear();
+}
+
+PackedInt32Array TouchControl::get_screen_heatmap(const HeatmapLayer p_layer) {
+	_commit_screen_touch();
+	return screen_heatmap.get_layer(TouchHeatmap::Layer(p_layer));
+}
+
+Ref<Image> TouchControl::get_screen_heatmap_image(const HeatmapLayer p_layer) {
+	_commit_screen_touch();
+	return screen_heatmap.get_layer_image(TouchHeatmap::Layer(p_layer));
+}
+
+Vector2i TouchControl::get_screen_heatmap_size() {
+	return Vector2i(screen_heatmap_cells, screen_heatmap_cells);
+}
+
+void TouchControl::clear_screen_heatmap() {
+	screen_touch.open = false;
+	screen_heatmap.clear();
+}
+
+TouchControl::TouchControl() {
+	profile.instantiate();
+}
+
+TouchControl::~TouchControl() {
+	if (heatmap)
+		delete heatmap;
+}
@@ -2,15 +2,93 @@
 #define TOUCH_CONTROL
 
 #include "scene/gui/control.h"
+#include "core/templates/local_vector.h"
+#include "TouchControlProfile.h"
+#include "TouchHeatmap.h"
+
+class TouchControl;
+
+struct TouchControlEvent {
+	enum Type {
+		EVENT_PRESSED,
+		EVENT_RELEASED,
+		EVENT_DIRECTION_CHANGED,
+		EVENT_ANGLE_CHANGED,
+		EVENT_SPEED_UPDATED // every physics tick a joystick monitors speed, -1 finger on release
+	};
+	Type type = EVENT_PRESSED;
+	const TouchControl* control = nullptr;
+	int finger = -1;
+	int direction = 0;
+	real_t angle = 0;
+	Vector2 drag_speed = Vector2();
+	real_t rotation_speed = 0;
+	real_t held_time = 0;
+};
+
+// Native consumers get every event of a control without Variants, register with TouchControl::add_listener.
+class TouchControlListener {
+public:
+	virtual void _touch_control_event(const TouchControlEvent& p_event) = 0;
+	virtual ~TouchControlListener() {}
+};
 
 class TouchControl : public Control {
 	GDCLASS(TouchControl, Control);
+public:
+	enum HeatmapLayer {
+		HEATMAP_PRESSES = TouchHeatmap::LAYER_PRESSES,
+		HEATMAP_MISSES = TouchHeatmap::LAYER_MISSES,
+		HEATMAP_DRAGS = TouchHeatmap::LAYER_DRAGS
+	};
 private:
 	int finger_pressed = -1;
 	bool passby_press = false;
+
+	LocalVector<TouchControlListener*> listeners;
+
+	Ref<TouchControlProfile> profile; // never null, a local one until a shared profile is set
+	bool profile_shared = false;
+	void _on_profile_changed();
+
+	TouchHeatmap* heatmap = nullptr; // opt in analytics, over the rect grown by a quarter of its size on every side
+	static TouchHeatmap screen_heatmap; // fed by one control since every control gets every touch
+	static ObjectID screen_heatmap_feeder;
+	// the touch down every analytics control is seeing, a screen miss is committed once none of them was hit
+	struct ScreenTouch {
+		Point2 point;
+		uint64_t frame = 0;
+		bool near = false; // in the margin of a control
+		bool hit = false;
+		bool open = false;
+	};
+	static ScreenTouch screen_touch;
+	static void _commit_screen_touch();
+	void _accumulate_touch(const Point2 p_screen_position, const Point2 p_local_position, const bool p_hit);
+	void _accumulate_drag(const Point2 p_screen_position, const Point2 p_local_position, const bool p_held);
+	bool _is_screen_heatmap_feeder();
 protected:
 	void _set_finger_index(int p_finger_pressed);
 
+	_FORCE_INLINE_ TouchControlProfile* _get_profile() const { return profile.ptr(); }
+	virtual void _profile_changed(); // the profile is only listened to inside the tree, entering it catches up
+
+	_FORCE_INLINE_ bool _has_listeners() const { return !listeners.is_empty(); }
+	void _notify_listeners(const TouchControlEvent& p_event) const;
+	bool _is_signal_connected(const StringName& p_signal) const; // skip boxing the arguments of a signal nobody listens to
+
+	// call on every touch down and drag before handling it, cost nothing while analytics is off
+	_FORCE_INLINE_ void _record_touch(const Point2 p_screen_position, const Point2 p_local_position, const bool p_hit) {
+		if (heatmap)
+			_accumulate_touch(p_screen_position, p_local_position, p_hit);
+	}
+	_FORCE_INLINE_ void _record_drag(const Point2 p_screen_position, const Point2 p_local_position, const int p_finger) {
+		if (heatmap)
+			_accumulate_drag(p_screen_position, p_local_position, p_finger == finger_pressed);
+	}
+
+	void _notification(int p_what);
+	void _validate_property(PropertyInfo& p_property) const;
 	static void _bind_methods();
 public:
 	int get_finger_index() const;
@@ -18,6 +96,26 @@ public:
 	bool is_passby_press() const;
 	void set_passby_press(bool p_passby_press);
 
+	void add_listener(TouchControlListener* p_listener); // the listener removes itself before it is freed
+	void remove_listener(TouchControlListener* p_listener);
+
+	void set_profile(const Ref<TouchControlProfile>& p_profile);
+	Ref<TouchControlProfile> get_profile() const; // null while the profile is local
+
+	void toggle_analytics(const bool p_enable);
+	bool is_analytics() const;
+	PackedInt32Array get_heatmap(const HeatmapLayer p_layer) const;
+	Ref<Image> get_heatmap_image(const HeatmapLayer p_layer) const;
+	Vector2i get_heatmap_size() const;
+	void clear_heatmap();
+	static PackedInt32Array get_screen_heatmap(const HeatmapLayer p_layer);
+	static Ref<Image> get_screen_heatmap_image(const HeatmapLayer p_layer);
+	static Vector2i get_screen_heatmap_size();
+	static void clear_screen_heatmap();
+
+	TouchControl();
+	~TouchControl();
+
 	/**
 		Don't use the following functions of Control
 		MouseFilter
@@ -27,4 +125,6 @@ public:
 	*/
 };
 
+VARIANT_ENUM_CAST(TouchControl::HeatmapLayer);
+
 #endif
@@ -0,0 +1,296 @@
+#include "TouchControlProfile.h"
+
+#include "servers/rendering_server.h"
+
+void TouchControlProfile::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_normal_texture", "texture"), &TouchControlProfile::set_normal_texture);
+	ClassDB::bind_method(D_METHOD("get_normal_texture"), &TouchControlProfile::get_normal_texture);
+	ClassDB::bind_method(D_METHOD("set_normal_scale", "scale"), &TouchControlProfile::set_normal_scale);
+	ClassDB::bind_method(D_METHOD("get_normal_scale"), &TouchControlProfile::get_normal_scale);
+
+	ClassDB::bind_method(D_METHOD("set_pressed_texture", "texture"), &TouchControlProfile::set_pressed_texture);
+	ClassDB::bind_method(D_METHOD("get_pressed_texture"), &TouchControlProfile::get_pressed_texture);
+	ClassDB::bind_method(D_METHOD("set_pressed_scale", "scale"), &TouchControlProfile::set_pressed_scale);
+	ClassDB::bind_method(D_METHOD("get_pressed_scale"), &TouchControlProfile::get_pressed_scale);
+
+	ClassDB::bind_method(D_METHOD("set_stick_texture", "texture"), &TouchControlProfile::set_stick_texture);
+	ClassDB::bind_method(D_METHOD("get_stick_texture"), &TouchControlProfile::get_stick_texture);
+	ClassDB::bind_method(D_METHOD("set_stick_scale", "scale"), &TouchControlProfile::set_stick_scale);
+	ClassDB::bind_method(D_METHOD("get_stick_scale"), &TouchControlProfile::get_stick_scale);
+
+	ClassDB::bind_method(D_METHOD("set_radius", "radius"), &TouchControlProfile::set_radius);
+	ClassDB::bind_method(D_METHOD("get_radius"), &TouchControlProfile::get_radius);
+	ClassDB::bind_method(D_METHOD("set_button_radius", "radius"), &TouchControlProfile::set_button_radius);
+	ClassDB::bind_method(D_METHOD("get_button_radius"), &TouchControlProfile::get_button_radius);
+	ClassDB::bind_method(D_METHOD("set_deadzone_extent", "extent"), &TouchControlProfile::set_deadzone_extent);
+	ClassDB::bind_method(D_METHOD("get_deadzone_extent"), &TouchControlProfile::get_deadzone_extent);
+	ClassDB::bind_method(D_METHOD("set_direction_span", "span"), &TouchControlProfile::set_direction_span);
+	ClassDB::bind_method(D_METHOD("get_direction_span"), &TouchControlProfile::get_direction_span);
+	ClassDB::bind_method(D_METHOD("set_show_mode", "show_mode"), &TouchControlProfile::set_show_mode);
+	ClassDB::bind_method(D_METHOD("get_show_mode"), &TouchControlProfile::get_show_mode);
+
+	ADD_GROUP("Normal", "normal_");
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "normal_texture", PROPERTY_HINT_RESOURCE_TYPE, "Texture2D"), "set_normal_texture", "get_normal_texture");
+	ADD_PROPERTY(PropertyInfo(Variant::VECTOR2, "normal_scale"), "set_normal_scale", "get_normal_scale");
+	ADD_GROUP("Pressed", "pressed_");
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "pressed_texture", PROPERTY_HINT_RESOURCE_TYPE, "Texture2D"), "set_pressed_texture", "get_pressed_texture");
+	ADD_PROPERTY(PropertyInfo(Variant::VECTOR2, "pressed_scale"), "set_pressed_scale", "get_pressed_scale");
+	ADD_GROUP("Stick", "stick_");
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "stick_texture", PROPERTY_HINT_RESOURCE_TYPE, "Texture2D"), "set_stick_texture", "get_stick_texture");
+	ADD_PROPERTY(PropertyInfo(Variant::VECTOR2, "stick_scale"), "set_stick_scale", "get_stick_scale");
+	ADD_GROUP("", "");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "radius"), "set_radius", "get_radius");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "button_radius"), "set_button_radius", "get_button_radius");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "deadzone_extent"), "set_deadzone_extent", "get_deadzone_extent");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "direction_span"), "set_direction_span", "get_direction_span");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "show_mode", PROPERTY_HINT_ENUM, "Show Stick On Touch,Show Stick & Normal On Touch,Show Stick When Inactive,Show All Always"), "set_show_mode", "get_show_mode");
+}
+
+void TouchControlProfile::_update_derived() {
+	_cardinal_angle = ((Math_PI * 0.5) - direction_span) * 0.5;
+#ifdef TOOLS_ENABLED
+	joystick_shape_dirty = true;
+#endif
+}
+
+#ifdef TOOLS_ENABLED
+TouchControlProfile::JoystickShape* TouchControlProfile::_get_joystick_shape() {
+	if (!joystick_shape)
+		joystick_shape = new TouchControlProfile::JoystickShape();
+	if (joystick_shape_dirty) {
+		joystick_shape->_update_shape_points(deadzone_extent, direction_span, radius == deadzone_extent);
+		joystick_shape_dirty = false;
+	}
+	return joystick_shape;
+}
+#endif
+
+void TouchControlProfile::set_normal_texture(const Ref<Texture2D>& p_texture) {
+	normal.texture = p_texture;
+	emit_changed();
+}
+Ref<Texture2D> TouchControlProfile::get_normal_texture() const {
+	return normal.texture;
+}
+void TouchControlProfile::set_normal_scale(Vector2 p_scale) {
+	normal.scale = Vector2(MAX(p_scale.x, 0), MAX(p_scale.y, 0));
+	emit_changed();
+}
+Vector2 TouchControlProfile::get_normal_scale() const {
+	return normal.scale;
+}
+void TouchControlProfile::set_pressed_texture(const Ref<Texture2D>& p_texture) {
+	pressed.texture = p_texture;
+	emit_changed();
+}
+Ref<Texture2D> TouchControlProfile::get_pressed_texture() const {
+	return pressed.texture;
+}
+void TouchControlProfile::set_pressed_scale(Vector2 p_scale) {
+	pressed.scale = Vector2(MAX(p_scale.x, 0), MAX(p_scale.y, 0));
+	emit_changed();
+}
+Vector2 TouchControlProfile::get_pressed_scale() const {
+	return pressed.scale;
+}
+void TouchControlProfile::set_stick_texture(const Ref<Texture2D>& p_texture) {
+	stick.texture = p_texture;
+	emit_changed();
+}
+Ref<Texture2D> TouchControlProfile::get_stick_texture() const {
+	return stick.texture;
+}
+void TouchControlProfile::set_stick_scale(Vector2 p_scale) {
+	stick.scale = Vector2(MAX(p_scale.x, 0), MAX(p_scale.y, 0));
+	emit_changed();
+}
+Vector2 TouchControlProfile::get_stick_scale() const {
+	return stick.scale;
+}
+
+void TouchControlProfile::set_radius(const real_t p_radius) {
+	radius = MAX(p_radius, 0);
+	_update_derived();
+	emit_changed();
+}
+real_t TouchControlProfile::get_radius() const {
+	return radius;
+}
+void TouchControlProfile::set_button_radius(const real_t p_radius) {
+	button_radius = MAX(p_radius, 0);
+	emit_changed();
+}
+real_t TouchControlProfile::get_button_radius() const {
+	return button_radius;
+}
+void TouchControlProfile::set_deadzone_extent(const real_t p_extent) {
+	deadzone_extent = MAX(p_extent, 0);
+	_update_derived();
+	emit_changed();
+}
+real_t TouchControlProfile::get_deadzone_extent() const {
+	return deadzone_extent;
+}
+void TouchControlProfile::set_direction_span(const real_t p_span) {
+	direction_span = CLAMP(p_span, 0, Math_PI * 0.5);
+	_update_derived();
+	emit_changed();
+}
+real_t TouchControlProfile::get_direction_span() const {
+	return direction_span;
+}
+void TouchControlProfile::set_show_mode(const int p_show_mode) {
+	show_mode = p_show_mode & 0b11;
+	emit_changed();
+}
+int TouchControlProfile::get_show_mode() const {
+	return show_mode;
+}
+
+TouchControlProfile::TouchControlProfile() {
+	normal.scale = Vector2(1.0, 1.0);
+	pressed.scale = Vector2(1.4, 1.4);
+	stick.scale = Vector2(0.3, 0.3);
+	_update_derived();
+}
+
+#ifdef TOOLS_ENABLED
+TouchControlProfile::~TouchControlProfile() {
+	if (joystick_shape)
+		delete joystick_shape;
+}
+
+TouchControlProfile::JoystickShape::JoystickShape()
+	: _deadzone_circle()
+{
+	_deadzone_circle.resize(24);
+	for (int i = 0; i < 3; ++i)
+		_palletes[i].resize(1);
+}
+
+void TouchControlProfile::JoystickShape::_update_shape_points(const real_t p_deadzone, const real_t p_direction_span, const bool is_radius_equal_deadzone) {
+	//draw points for circle in the middle and 8 or 4 quarter disks in the outer edges
+	const real_t rad90deg = Math_PI * 0.5;
+	const real_t angle = (p_direction_span + CMP_EPSILON < rad90deg ? rad90deg - p_direction_span : 0.0);
+	const real_t half_angle = angle * 0.5;
+	const real_t start_angle[4] = { (2.0f * Math_PI) - half_angle, (0.5f * Math_PI) - half_angle, -half_angle + Math_PI, (1.5f * Math_PI) - half_angle }; // (360, 90, 180, 270) - angle
+	const real_t end_angle[4] = { half_angle,  (0.5f * Math_PI) + half_angle, half_angle + Math_PI, (1.5f * Math_PI) + half_angle }; // (0, 90, 180, 270) + angle
+	unsigned int marked_edges[8] = { 0,0,0,0,0,0,0,0 }; // { upStart, upEnd, rightStart, rightEnd, downStart, downEnd, leftStart, leftEnd }
+	Point2* circle = _deadzone_circle.ptrw();
+	for (int i = 0, j = 0, k = 1; i < 24; i++) {
+		const real_t theta = Math_PI * i / 12.0f;
+		circle[i] = Vector2(Math::cos(theta), Math::sin(theta)) * p_deadzone; // deadzone circle
+		if (j < 4 && end_angle[j] <= theta) { // up, right, down, left
+			marked_edges[1 + j * 2] = MAX(i - 1, 0);
+			j++;
+		}
+		if (k < 5 && start_angle[k % 4] <= theta) { // right, down, left, up
+			marked_edges[(k % 4) * 2] = i - 1;
+			k++;
+		}
+	}
+
+	if (is_radius_equal_deadzone)
+		return;
+
+	Point2 points[6]; // outer ring, at most 2 + 4 points for a quarter circle
+	//[0-3] is Up Down Left Right
+	if (p_direction_span + CMP_EPSILON < rad90deg) {
+		const unsigned short int size = MIN(2u + 4u * (angle / rad90deg), 6u); // outer ring // 2 for the start and end edges of the outer ring
+		const real_t angle_increments = angle / (real_t)(size - 1);
+
+		for (int i = 0; i < size; ++i) {
+			const real_t theta = (angle_increments * i) - (half_angle); // outer ring points
+			points[i] = Vector2(Math::cos(theta), Math::sin(theta));
+		}
+		for (int i = 0; i < 4; ++i) { // outer ring of circle
+			_direction_zones[i].resize(3 + size + (i ? marked_edges[1 + i * 2] - marked_edges[i * 2] : ((marked_edges[1] + 24 - marked_edges[0]) % 24))); // +2 for start and end edges of the inner ring and +1 for extra size
+			Point2* res = _direction_zones[i].ptrw();
+			const int res_size = _direction_zones[i].size();
+			for (int j = 0; j < size; ++j) {
+				const Vector2& point = points[j];
+				if (i % 2)  //outer ring points plus center and if up, down, left, right
+					res[j] = Vector2(point.y, point.x) * (i % 3 ? Vector2(-1, 1) : Vector2(1, -1)); // i is 1 or 3; 1 is left; 3 is right
+				else
+					res[j] = point * (i ? Vector2(-1, -1) : Vector2(1, 1)); // i is 0 or 2; 2 is down; 0 is up
+			}
+			res[size] = Vector2(Math::cos(end_angle[i]), Math::sin(end_angle[i])) * p_deadzone; // inner ring of the circle end edge
+			for (int index = marked_edges[i * 2], res_rend = res_size - 2; index != marked_edges[1 + i * 2] + 1; --res_rend) { // j is startEdge and condition is if j != endEdge + 1
+				res[res_rend] = circle[index];
+				++index %= 24;
+			}
+			res[res_size - 1] = Vector2(Math::cos(start_angle[i]), Math::sin(start_angle[i])) * p_deadzone; // inner ring of the circle start edge
+		}
+	}
+	else
+		_direction_zones[0].clear();
+
+	if (!(p_direction_span > CMP_EPSILON)) {
+		_direction_zones[4].clear();
+		return;
+	}
+	//[4-7] is UpRight UpLeft DownRight DownLeft
+	const unsigned short int size = MIN(2u + 4u * (p_direction_span / rad90deg), 6u);
+	const real_t angle_increments = p_direction_span / (real_t)(size - 1);
+	for (int i = 0; i < size; ++i) {
+		const real_t theta = (angle_increments * i) + half_angle;
+		points[i] = Vector2(Math::cos(theta), Math::sin(theta));
+	}
+	for (int i = 0; i < 4; ++i) {
+		_direction_zones[i + 4].resize(3 + size + (i != 3 ? marked_edges[(2 + i * 2) % 8] - marked_edges[1 + i * 2] : (marked_edges[0] + 24 - marked_edges[7]) % 24)); // end edge of up subtracted by start edge of right... and so on so forth for the other edges
+		Point2* res = _direction_zones[i + 4].ptrw();
+		const int res_size = _direction_zones[i + 4].size();
+		for (int j = 0; j < size; ++j) {
+			const Vector2& point = points[j];
+			if (i % 2) //downright, downleft
+				res[j] = Vector2(point.y, point.x) * (i % 3 ? Vector2(-1, 1) : Vector2(1, -1));
+			else  //upright, downleft
+				res[j] = point * (i ? Vector2(-1, -1) : Vector2(1, 1));
+		}
+		res[size] = Vector2(Math::cos(start_angle[(i + 1) % 4]), Math::sin(start_angle[(i + 1) % 4])) * p_deadzone;
+		for (int index = marked_edges[1 + i * 2], res_rend = res_size - 2; index != marked_edges[(2 + i * 2) % 8] + 1; --res_rend) {
+			res[res_rend] = circle[index];
+			++index %= 24;
+		}
+		res[res_size - 1] = Vector2(Math::cos(end_angle[i]), Math::sin(end_angle[i])) * p_deadzone;
+	}
+}
+
+// the palletes are written in place, shared by every joystick using the profile since drawing is single threaded
+void TouchControlProfile::JoystickShape::_draw(const RID& p_rid_to, const Point2 p_center, const real_t p_radius, Color pallete, const bool is_radius_equal_deadzone) {
+	if (p_radius <= 0)
+		return;
+	Transform2D xform;
+	xform.scale_basis(Size2(p_radius, p_radius));
+	xform.set_origin(p_center);
+	RenderingServer::get_singleton()->canvas_item_add_set_transform(p_rid_to, xform);
+	const real_t width = 1.0 / p_radius; // one pixel once scaled
+
+	_palletes[0].write[0] = pallete.darkened(0.15);
+	_add_to_canvas(p_rid_to, _deadzone_circle, _palletes[0], width);
+
+	if (!is_radius_equal_deadzone) {
+		if (_direction_zones[0].size() != 0) {
+			_palletes[1].write[0] = pallete;
+			for (int i = 0; i < 4; ++i)
+				_add_to_canvas(p_rid_to, _direction_zones[i], _palletes[1], width);
+		}
+
+		if (_direction_zones[4].size() != 0) {
+			_palletes[2].write[0] = pallete.lightened(0.15);
+			for (int i = 4; i < 8; ++i)
+				_add_to_canvas(p_rid_to, _direction_zones[i], _palletes[2], width);
+		}
+	}
+	RenderingServer::get_singleton()->canvas_item_add_set_transform(p_rid_to, Transform2D());
+}
+
+void TouchControlProfile::JoystickShape::_add_to_canvas(const RID p_rid_to, const Vector<Vector2>& p_points, const Vector<Color>& p_color, const real_t p_width) {
+	RenderingServer::get_singleton()->canvas_item_add_polygon(p_rid_to, p_points, p_color);
+	RenderingServer::get_singleton()->canvas_item_add_polyline(p_rid_to, p_points, p_color, p_width, true);
+	// Draw the last segment as it's not drawn by `canvas_item_add_polyline()`.
+	RenderingServer::get_singleton()->canvas_item_add_line(p_rid_to, p_points[p_points.size() - 1], p_points[0], p_color[0], p_width, true);
+}
+#else
+TouchControlProfile::~TouchControlProfile() {}
+#endif
@@ -0,0 +1,90 @@
+#ifndef TOUCH_CONTROL_PROFILE
+#define TOUCH_CONTROL_PROFILE
+
+#include "core/io/resource.h"
+#include "scene/resources/texture.h"
+
+// Skin and tuning of touch controls, every control referencing a profile reads it instead of keeping its own copy.
+// Derived data is normalized to the size of a control, so controls of any size share it.
+class TouchControlProfile : public Resource {
+	GDCLASS(TouchControlProfile, Resource);
+	OBJ_SAVE_TYPE(TouchControlProfile);
+
+public:
+	struct TextureData {
+		Ref<Texture2D> texture = Ref<Texture2D>();
+		Vector2 scale = Vector2(); // of the size of the control, zero keeps the texture size
+	};
+
+private:
+	TextureData normal, pressed, stick;
+	real_t radius = 1.0; // joystick, of half the smaller side of the control
+	real_t button_radius = 0.0; // in pixels, zero presses anywhere inside the rect
+	real_t deadzone_extent = 0.4;
+	real_t direction_span = 0.575;
+	int show_mode = 0b11;
+
+	real_t _cardinal_angle = 0; // below it a joystick direction is only horizontal, above half pi minus it only vertical
+
+#ifdef TOOLS_ENABLED
+public:
+	// debug shape of a joystick around the origin with a radius of 1, scaled to the control when drawn
+	class JoystickShape {
+		Vector<Point2> _deadzone_circle;
+		Vector<Point2> _direction_zones[8]; // written in place, only resized when the direction span changes
+		Vector<Color> _palletes[3];
+
+		void _add_to_canvas(const RID p_rid_to, const Vector<Vector2>& p_points, const Vector<Color>& p_color, const real_t p_width);
+	public:
+		JoystickShape();
+
+		void _update_shape_points(const real_t p_deadzone, const real_t p_direction_span, const bool is_radius_equal_deadzone);
+		void _draw(const RID& p_rid_to, const Point2 p_center, const real_t p_radius, Color pallete, const bool is_radius_equal_deadzone);
+	};
+private:
+	JoystickShape* joystick_shape = nullptr; // built once a control draws it
+	bool joystick_shape_dirty = true;
+#endif
+
+	void _update_derived();
+
+protected:
+	static void _bind_methods();
+public:
+	void set_normal_texture(const Ref<Texture2D>& p_texture);
+	Ref<Texture2D> get_normal_texture() const;
+	void set_normal_scale(Vector2 p_scale);
+	Vector2 get_normal_scale() const;
+	void set_pressed_texture(const Ref<Texture2D>& p_texture);
+	Ref<Texture2D> get_pressed_texture() const;
+	void set_pressed_scale(Vector2 p_scale);
+	Vector2 get_pressed_scale() const;
+	void set_stick_texture(const Ref<Texture2D>& p_texture);
+	Ref<Texture2D> get_stick_texture() const;
+	void set_stick_scale(Vector2 p_scale);
+	Vector2 get_stick_scale() const;
+
+	void set_radius(const real_t p_radius);
+	real_t get_radius() const;
+	void set_button_radius(const real_t p_radius);
+	real_t get_button_radius() const;
+	void set_deadzone_extent(const real_t p_extent);
+	real_t get_deadzone_extent() const;
+	void set_direction_span(const real_t p_span);
+	real_t get_direction_span() const;
+	void set_show_mode(const int p_show_mode);
+	int get_show_mode() const;
+
+	_FORCE_INLINE_ const TextureData& _normal() const { return normal; }
+	_FORCE_INLINE_ const TextureData& _pressed() const { return pressed; }
+	_FORCE_INLINE_ const TextureData& _stick() const { return stick; }
+	_FORCE_INLINE_ real_t _get_cardinal_angle() const { return _cardinal_angle; }
+#ifdef TOOLS_ENABLED
+	JoystickShape* _get_joystick_shape(); // rebuilt once the tuning changed
+#endif
+
+	TouchControlProfile();
+	~TouchControlProfile();
+};
+
+#endif
@@ -0,0 +1,59 @@
+#include "TouchHeatmap.h"
+
+void TouchHeatmap::setup(const int p_width, const int p_height) {
+	ERR_FAIL_COND(p_width <= 0 || p_height <= 0);
+	width = p_width;
+	height = p_height;
+	cells.resize(width * height * LAYER_MAX);
+	clear();
+}
+
+void TouchHeatmap::clear() {
+	for (uint32_t i = 0; i < cells.size(); ++i)
+		cells[i] = 0;
+}
+
+uint32_t TouchHeatmap::get_cell(const Layer p_layer, const Vector2i p_cell) const {
+	ERR_FAIL_INDEX_V(p_layer, LAYER_MAX, 0);
+	ERR_FAIL_COND_V(p_cell.x < 0 || p_cell.y < 0 || p_cell.x >= width || p_cell.y >= height, 0);
+	return cells[(p_layer * height + p_cell.y) * width + p_cell.x];
+}
+
+void TouchHeatmap::set_cell(const Layer p_layer, const Vector2i p_cell, const uint32_t p_count) {
+	ERR_FAIL_INDEX(p_layer, LAYER_MAX);
+	ERR_FAIL_COND(p_cell.x < 0 || p_cell.y < 0 || p_cell.x >= width || p_cell.y >= height);
+	cells[(p_layer * height + p_cell.y) * width + p_cell.x] = p_count;
+}
+
+Vector2i TouchHeatmap::get_size() const {
+	return Vector2i(width, height);
+}
+
+PackedInt32Array TouchHeatmap::get_layer(const Layer p_layer) const {
+	ERR_FAIL_INDEX_V(p_layer, LAYER_MAX, PackedInt32Array());
+	PackedInt32Array res;
+	if (cells.is_empty())
+		return res;
+	res.resize(width * height);
+	int32_t* w = res.ptrw();
+	const uint32_t* r = cells.ptr() + p_layer * width * height;
+	for (int i = 0; i < width * height; ++i)
+		w[i] = MIN(r[i], (uint32_t)INT32_MAX);
+	return res;
+}
+
+Ref<Image> TouchHeatmap::get_layer_image(const Layer p_layer) const {
+	ERR_FAIL_INDEX_V(p_layer, LAYER_MAX, Ref<Image>());
+	ERR_FAIL_COND_V_MSG(cells.is_empty(), Ref<Image>(), "The heatmap has no cells yet.");
+	const uint32_t* r = cells.ptr() + p_layer * width * height;
+	uint32_t busiest = 0;
+	for (int i = 0; i < width * height; ++i)
+		busiest = MAX(busiest, r[i]);
+
+	Vector<uint8_t> data;
+	data.resize(width * height * sizeof(float));
+	float* w = (float*)data.ptrw();
+	for (int i = 0; i < width * height; ++i)
+		w[i] = (busiest ? float(r[i]) / float(busiest) : 0.0f);
+	return Image::create_from_data(width, height, false, Image::FORMAT_RF, data);
+}
@@ -0,0 +1,44 @@
+#ifndef TOUCH_HEATMAP
+#define TOUCH_HEATMAP
+
+#include "core/templates/local_vector.h"
+#include "core/io/image.h"
+
+// Touch counts on a fixed grid of cells over a normalized area.
+// The cells are allocated once in setup, adding a touch is an index and an increment.
+class TouchHeatmap {
+public:
+	enum Layer {
+		LAYER_PRESSES, // touch downs on the hit shape
+		LAYER_MISSES, // touch downs next to it
+		LAYER_DRAGS, // drag path of the finger holding the control
+		LAYER_MAX
+	};
+
+private:
+	LocalVector<uint32_t> cells; // layer after layer, row by row
+	int width = 0;
+	int height = 0;
+
+public:
+	void setup(const int p_width, const int p_height);
+	_FORCE_INLINE_ bool is_setup() const { return !cells.is_empty(); }
+
+	// p_point is normalized to the area, points outside of [0, 1) are dropped
+	_FORCE_INLINE_ void add(const Layer p_layer, const Vector2 p_point) {
+		if (!(p_point.x >= 0 && p_point.y >= 0 && p_point.x < 1 && p_point.y < 1) || cells.is_empty())
+			return;
+		uint32_t& cell = cells[(p_layer * height + int(p_point.y * height)) * width + int(p_point.x * width)];
+		if (cell != UINT32_MAX)
+			++cell;
+	}
+	void clear();
+	uint32_t get_cell(const Layer p_layer, const Vector2i p_cell) const;
+	void set_cell(const Layer p_layer, const Vector2i p_cell, const uint32_t p_count); // restores saved counts
+
+	Vector2i get_size() const;
+	PackedInt32Array get_layer(const Layer p_layer) const;
+	Ref<Image> get_layer_image(const Layer p_layer) const; // one float per cell, relative to the busiest cell of the layer
+};
+
+#endif
@@ -0,0 +1,109 @@
+#include "TouchInputQueue.h"
+
+#include "core/config/engine.h"
+#include "core/os/os.h"
+#include "scene/main/scene_tree.h"
+#include "TouchControl.h"
+
+TouchInputQueue* TouchInputQueue::singleton = nullptr;
+
+void TouchInputQueue::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("get_transition_count"), &TouchInputQueue::get_transition_count);
+	ClassDB::bind_method(D_METHOD("get_transitions"), &TouchInputQueue::get_transitions);
+}
+
+TouchInputQueue* TouchInputQueue::get_singleton() {
+	return singleton;
+}
+
+static const uint32_t max_pending = 256; // without a tree nothing consumes, the oldest are dropped
+
+void TouchInputQueue::push(const TouchControl* p_control, const TouchInputTransition::Kind p_kind, const int32_t p_value) {
+	_connect_tree();
+	if (pending.size() >= max_pending)
+		pending.remove_at(0);
+	TouchInputTransition transition;
+	transition.control = p_control->get_instance_id();
+	transition.usec = OS::get_singleton()->get_ticks_usec();
+	// input is flushed before the steps of a frame, the frame counter only moves at the end of a step
+	const Engine* engine = Engine::get_singleton();
+	transition.frame = engine->get_physics_frames() + (engine->is_in_physics_frame() ? 1 : 0);
+	transition.value = p_value;
+	transition.kind = p_kind;
+	pending.push_back(transition);
+}
+
+void TouchInputQueue::_connect_tree() {
+	SceneTree* scene_tree = SceneTree::get_singleton();
+	if (!scene_tree || scene_tree->get_instance_id() == tree)
+		return;
+	tree = scene_tree->get_instance_id();
+	scene_tree->connect(SNAME("physics_frame"), callable_mp(this, &TouchInputQueue::_advance));
+}
+
+void TouchInputQueue::_advance() {
+	// physics_frame is emitted once per tick, the frame counter only moves once the tick ended
+	const uint64_t frame = Engine::get_singleton()->get_physics_frames();
+	const uint64_t now = OS::get_singleton()->get_ticks_usec();
+	const uint64_t previous_tick_usec = tick_usec;
+	const double span = (previous_tick_usec && now > previous_tick_usec ? double(now - previous_tick_usec) : 1.0);
+	tick_usec = now;
+
+	transitions.clear();
+	for (uint32_t i = 0; i < carried.size(); ++i) {
+		carried[i].sub_tick = 0;
+		transitions.push_back(carried[i]);
+	}
+	carried.clear();
+	uint32_t later = 0; // pushed during this tick, kept for the next one in order
+	for (uint32_t i = 0; i < pending.size(); ++i) {
+		TouchInputTransition& transition = pending[i];
+		if (transition.frame > frame) {
+			pending[later++] = transition;
+			continue;
+		}
+		transition.sub_tick = CLAMP((transition.usec - (double)previous_tick_usec) / span, 0.0, 1.0);
+		// once a control is carried, its later transitions follow to keep their order
+		bool carry = false;
+		for (uint32_t j = 0; j < carried.size() && !carry; ++j)
+			carry = carried[j].control == transition.control;
+		for (uint32_t j = 0; j < transitions.size() && !carry && transition.kind == TouchInputTransition::KIND_BUTTON && !transition.value; ++j)
+			carry = transitions[j].control == transition.control && transitions[j].kind == TouchInputTransition::KIND_BUTTON && transitions[j].value;
+		if (carry)
+			carried.push_back(transition);
+		else
+			transitions.push_back(transition);
+	}
+	pending.resize(later);
+}
+
+uint32_t TouchInputQueue::get_transition_count() const {
+	return transitions.size();
+}
+
+const TouchInputTransition& TouchInputQueue::get_transition(const uint32_t p_index) const {
+	CRASH_BAD_UNSIGNED_INDEX(p_index, transitions.size());
+	return transitions[p_index];
+}
+
+Array TouchInputQueue::get_transitions() const {
+	Array res;
+	res.resize(transitions.size());
+	for (uint32_t i = 0; i < transitions.size(); ++i) {
+		Dictionary transition;
+		transition["control"] = ObjectDB::get_instance(transitions[i].control);
+		transition["kind"] = transitions[i].kind;
+		transition["value"] = transitions[i].value;
+		transition["usec"] = transitions[i].usec;
+		transition["sub_tick"] = transitions[i].sub_tick;
+		res[i] = transition;
+	}
+	return res;
+}
+
+TouchInputQueue::TouchInputQueue() {
+	singleton = this;
+}
+TouchInputQueue::~TouchInputQueue() {
+	singleton = nullptr;
+}
@@ -0,0 +1,54 @@
+#ifndef TOUCH_INPUT_QUEUE
+#define TOUCH_INPUT_QUEUE
+
+#include "core/object/class_db.h"
+#include "core/templates/local_vector.h"
+
+class TouchControl;
+
+struct TouchInputTransition {
+	enum Kind {
+		KIND_BUTTON, // value is 1 on press, 0 on release
+		KIND_DIRECTION // value is the TouchScreenPad::Direction
+	};
+	ObjectID control;
+	uint64_t usec = 0;
+	uint64_t frame = 0; // physics frame consuming it
+	real_t sub_tick = 0; // 0 at the start of the previous physics tick, 1 at the start of the tick consuming it
+	int32_t value = 0;
+	Kind kind = KIND_BUTTON;
+};
+
+// Transitions of every TouchControl in the order they happened, handed to physics one tick at a time.
+// Tick N consumes every transition stamped with frame N or earlier, the hand over happens as the tick starts.
+// A release in the same tick as its press is carried to the next tick, so every press is seen by a tick.
+class TouchInputQueue : public Object {
+	GDCLASS(TouchInputQueue, Object);
+
+	static TouchInputQueue* singleton;
+
+	LocalVector<TouchInputTransition> pending; // pushed since the last tick
+	LocalVector<TouchInputTransition> transitions; // of the current tick
+	LocalVector<TouchInputTransition> carried; // to the next tick
+	uint64_t tick_usec = 0; // start of the current tick
+	ObjectID tree; // whose physics_frame signal advances the queue
+
+	void _connect_tree();
+	void _advance(); // at the start of every physics tick
+
+protected:
+	static void _bind_methods();
+public:
+	static TouchInputQueue* get_singleton();
+
+	void push(const TouchControl* p_control, const TouchInputTransition::Kind p_kind, const int32_t p_value);
+
+	uint32_t get_transition_count() const;
+	const TouchInputTransition& get_transition(const uint32_t p_index) const;
+	Array get_transitions() const; // of dictionaries, for scripts
+
+	TouchInputQueue();
+	~TouchInputQueue();
+};
+
+#endif
@@ -5,8 +5,10 @@
 #include "core/math/color.h"
 #include "core/templates/vector.h"
 #include "core/input/input_event.h"
+#include "../Profiling/Tracer.h"
 
 void TouchScreenDPad::input(const Ref<InputEvent>& p_event) {
+	TRACE_SCOPE("TouchScreenDPad::input");
 	ERR_FAIL_COND(p_event.is_null());
 
 	if (!is_visible_in_tree()) {
@@ -16,7 +18,10 @@ void TouchScreenDPad::input(const Ref<InputEvent>& p_event) {
 	const InputEventScreenTouch *st = Object::cast_to<InputEventScreenTouch>(*p_event);
 	if (st) {
 		Point2 coord = get_global_transform_with_canvas().xform_inv(st->get_position());
-		if (Control::has_point(coord) && get_finger_index() == -1 && st->is_pressed()) { //press inside Control.rect
+		const bool inside = Control::has_point(coord);
+		if (st->is_pressed())
+			_record_touch(st->get_position(), coord, inside);
+		if (inside && get_finger_index() == -1 && st->is_pressed()) { //press inside Control.rect
 			_set_finger_index(st->get_index());
 			_update_direction_with_point(coord);
 		} else if (get_finger_index() == st->get_index()) //on release
@@ -27,6 +32,7 @@ void TouchScreenDPad::input(const Ref<InputEvent>& p_event) {
 	const InputEventScreenDrag *sd = Object::cast_to<InputEventScreenDrag>(*p_event);
 	if (sd) {
 		Point2 coord = get_global_transform_with_canvas().xform_inv(sd->get_position());
+		_record_drag(sd->get_position(), coord, sd->get_index());
 		if (is_passby_press() && get_finger_index() == -1 && Control::has_point(coord)) { //passby press enter Control.rect
 			_set_finger_index(sd->get_index());
 			_update_direction_with_point(coord);
@@ -36,6 +42,7 @@ void TouchScreenDPad::input(const Ref<InputEvent>& p_event) {
 }
 
 void TouchScreenDPad::_update_direction_with_point(Point2 p_point) {
+	TRACE_SCOPE("TouchScreenDPad::_update_direction_with_point");
 	int result = DIR_NEUTRAL;
 	p_point -= ((get_size() / 2.0) + get_center_offset());
 	Direction xAxis = p_point.x > 0 ? DIR_RIGHT : DIR_LEFT;
@@ -76,14 +83,16 @@ const bool TouchScreenDPad::_set_cardinal_direction_span(real_t p_span) {
 }
 
 Size2 TouchScreenDPad::get_minimum_size() const {
-	if (scale_to_rect.length() == 0.0 && texture.is_valid())
-		return texture->get_size();
+	const TouchControlProfile::TextureData& normal = _get_profile()->_normal();
+	if (normal.scale.length() == 0.0 && normal.texture.is_valid())
+		return normal.texture->get_size();
 	return Control::get_minimum_size().abs();
 }
 
 void TouchScreenDPad::_notification(int p_what) {
 	switch (p_what) {
 		case NOTIFICATION_DRAW: {
+			const Ref<Texture2D>& texture = _get_profile()->_normal().texture;
 			if (texture.is_null()) {
 				return;
 			}
@@ -103,9 +112,10 @@ void TouchScreenDPad::_notification(int p_what) {
 }
 
 void TouchScreenDPad::_update_cache() {
-	if(texture.is_null())
+	const TouchControlProfile::TextureData& normal = _get_profile()->_normal();
+	if(normal.texture.is_null())
 		return;
-	Size2 size = scale_to_rect.length() == 0.0? texture->get_size() : (get_size() * scale_to_rect);
+	Size2 size = normal.scale.length() == 0.0? normal.texture->get_size() : (get_size() * normal.scale);
 	_position_rect = Rect2((is_centered() ? (get_size() - size) / 2.0f : Point2(0, 0)), size);
 #ifdef TOOLS_ENABLED
 	if (Engine::get_singleton()->is_editor_hint() || (is_inside_tree() && get_tree()->is_debugging_collisions_hint())) 
@@ -113,28 +123,21 @@ void TouchScreenDPad::_update_cache() {
 #endif
 }
 
+// the profile refreshes the control once it changed
 Ref<Texture2D> TouchScreenDPad::get_texture() const {
-	return texture;
+	return _get_profile()->get_normal_texture();
 }
 
 void TouchScreenDPad::set_texture(const Ref<Texture2D> p_texture) {
-	texture = p_texture;
-	_update_cache_dirty();
-	update_minimum_size();
-	queue_redraw();
+	_get_profile()->set_normal_texture(p_texture);
 }
 
 Point2 TouchScreenDPad::get_scale_to_rect() const {
-	return scale_to_rect;
+	return _get_profile()->get_normal_scale();
 }
 
 void TouchScreenDPad::set_scale_to_rect(Point2 p_scale) {
-	p_scale.x = MAX(p_scale.x, 0);
-	p_scale.y = MAX(p_scale.y, 0);
-	scale_to_rect = p_scale;
-	_update_cache_dirty();
-	update_minimum_size();
-	queue_redraw();
+	_get_profile()->set_normal_scale(p_scale);
 }
 
 void TouchScreenDPad::_bind_methods() {
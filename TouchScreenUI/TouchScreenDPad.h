@@ -10,10 +10,7 @@ class TouchScreenDPad : public TouchScreenPad {
 	GDCLASS(TouchScreenDPad, TouchScreenPad);
 
 private:
-	Ref<Texture2D> texture;
-	Point2 scale_to_rect = Point2(1, 1);
-
-	Rect2 _position_rect = Rect2();
+	Rect2 _position_rect = Rect2(); // texture and scale to rect are the normal ones of the profile
 #ifdef TOOLS_ENABLED
 	Ref<ConvexPolygonShape2D> _shape_points; // put in a struct then ifdef with tools enabled
 #endif
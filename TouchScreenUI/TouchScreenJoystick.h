@@ -18,35 +18,15 @@ public:
 	};
 
 private:
-#ifdef TOOLS_ENABLED
-	class Shape {
-		Vector<Point2> _deadzone_circle;
-		Vector<Vector<Point2>> _direction_zones;
-
-		void _add_to_canvas(const RID p_rid_to, const Vector<Vector2>& p_points, const Vector<Color>& p_color);
-	public:
-		Shape();
-
-		void _update_shape_points(const Point2 p_center, const real_t p_radius, const real_t p_deadzone, const real_t p_direction_span, const bool is_radius_equal_deadzone);
-		void _draw(const RID& p_rid_to, Color pallete, const bool is_radius_equal_deadzone);
-	} * shape = nullptr;
-#endif
-
-	struct Data {
+	struct Data { // textures, scales, radius and show mode are in the profile, the rects depend on the size
 		struct TextureData {
-			Ref<Texture2D> texture = Ref<Texture2D>();
 			Rect2 _position_rect = Rect2();
-			Vector2 scale = Vector2();
 
 			_FORCE_INLINE_ const Rect2 move_to_position(const Point2& p_point) const;
-			void _update_texture_cache(const Size2 parent_size, const bool is_centered);
+			void _update_texture_cache(const TouchControlProfile::TextureData& p_texture, const Size2 parent_size, const bool is_centered);
 		} normal, pressed, stick;
-
-		Data();
 	} data;
-	real_t radius = 1.0;
-	
-	ShowMode show_mode = SHOW_ALL_ALWAYS;
+
 	bool stick_confined_inside = false; //keep clip content false
 	bool normal_moved_to_touch_pos = false;
 
@@ -104,6 +84,7 @@ public:
 	bool is_monitoring_speed() const;
 
 	real_t get_angle() const;
+	virtual Vector2 get_vector() const override; // zero inside the deadzone
 	real_t get_rotation_speed() const;
 	Vector2 get_drag_speed() const;
 
@@ -113,6 +94,7 @@ private:
 	virtual void input(const Ref<InputEvent>& p_event) override;
 
 	void _update_direction_with_point(Point2 p_point);
+	void _speed_updated(const Vector2 p_drag_speed, const real_t p_rotation_speed);
 	inline const bool _is_point_inside(const Point2 p_point);
 
 	void _update_cache();
@@ -1,9 +1,11 @@
 #include "TouchScreenPad.h"
 
 #include "core/os/os.h"
+#include "TouchInputQueue.h"
+#include "../Profiling/Tracer.h"
 
 const bool TouchScreenPad::_set_cardinal_direction_span(real_t p_span) {
-	cardinal_direction_span = p_span;
+	_get_profile()->set_direction_span(p_span);
 	return true;
 }
 
@@ -12,7 +14,7 @@ void TouchScreenPad::_set_direction(Direction p_direction) {
 }
 
 const bool TouchScreenPad::_set_deadzone_extent(real_t p_extent) {
-	deadzone_extent = p_extent;
+	_get_profile()->set_deadzone_extent(p_extent);
 	return true;
 }
 
@@ -75,6 +77,8 @@ void TouchScreenPad::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_cardinal_direction_span", "span"), &TouchScreenPad::set_cardinal_direction_span);
 
 	ClassDB::bind_method(D_METHOD("get_direction"), &TouchScreenPad::get_direction);
+	ClassDB::bind_method(D_METHOD("get_vector"), &TouchScreenPad::get_vector);
+	ClassDB::bind_method(D_METHOD("get_direction_plug"), &TouchScreenPad::get_direction_plug);
 
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "centered"), "set_centered", "is_centered");
 	ADD_PROPERTY(PropertyInfo(Variant::VECTOR2, "center offset"), "set_center_offset", "get_center_offset");
@@ -98,13 +102,30 @@ void TouchScreenPad::_bind_methods() {
 }
 
 void TouchScreenPad::_direction_changed() {
-	emit_signal("direction_changed", Variant(get_finger_index()), Variant(direction));
+	TRACE_SCOPE("TouchScreenPad::_direction_changed");
+	if (TouchInputQueue::get_singleton())
+		TouchInputQueue::get_singleton()->push(this, TouchInputTransition::KIND_DIRECTION, direction);
+	if (direction_plug.is_valid()) {
+		PlugSample sample;
+		sample.integer = direction;
+		direction_plug->push(sample);
+	}
+	if (_has_listeners()) {
+		TouchControlEvent event;
+		event.type = TouchControlEvent::EVENT_DIRECTION_CHANGED;
+		event.control = this;
+		event.finger = get_finger_index();
+		event.direction = direction;
+		_notify_listeners(event);
+	}
+	if (_is_signal_connected(SNAME("direction_changed")))
+		emit_signal(SNAME("direction_changed"), get_finger_index(), direction);
 }
 
 void TouchScreenPad::_release() {
 	_set_finger_index(-1);
 	direction = DIR_NEUTRAL;
-	emit_signal("direction_changed", Variant(get_finger_index()), Variant(direction));
+	_direction_changed();
 }
 
 void TouchScreenPad::set_centered(bool p_centered) {
@@ -127,13 +148,26 @@ void TouchScreenPad::set_deadzone_extent(real_t p_extent) {
 }
 
 real_t TouchScreenPad::get_deadzone_extent() const {
-	return deadzone_extent;
+	return _get_profile()->get_deadzone_extent();
 }
 
 TouchScreenPad::Direction TouchScreenPad::get_direction() const {
 	return direction;
 }
 
+Vector2 TouchScreenPad::get_vector() const {
+	const Vector2 res = Vector2((direction & DIR_RIGHT) ? 1 : ((direction & DIR_LEFT) ? -1 : 0), (direction & DIR_DOWN) ? 1 : ((direction & DIR_UP) ? -1 : 0));
+	return res.normalized();
+}
+
+Ref<OutputPlug> TouchScreenPad::get_direction_plug() {
+	if (direction_plug.is_null()) {
+		direction_plug.instantiate();
+		direction_plug->setup(OutputPlug::TYPE_INT, 16);
+	}
+	return direction_plug;
+}
+
 void TouchScreenPad::set_center_offset(Point2 p_offset) {
 	offset_center = p_offset;
 	if (Engine::get_singleton()->is_editor_hint() || (is_inside_tree() && get_tree()->is_debugging_collisions_hint())) {
@@ -156,7 +190,7 @@ void TouchScreenPad::set_cardinal_direction_span(real_t p_span) {
 }
 
 real_t TouchScreenPad::get_cardinal_direction_span() const {
-	return cardinal_direction_span;
+	return _get_profile()->get_direction_span();
 }
 
 void TouchScreenPad::_update_cache_dirty() {
@@ -170,6 +204,13 @@ bool TouchScreenPad::is_update_cache() {
 	return true;
 }
 
-TouchScreenPad::TouchScreenPad(real_t p_extent, real_t p_span)
-	: deadzone_extent(p_extent), cardinal_direction_span(p_span) {}
+void TouchScreenPad::_profile_changed() {
+	_update_cache_dirty();
+	TouchControl::_profile_changed();
+}
+
+TouchScreenPad::TouchScreenPad(real_t p_extent, real_t p_span) {
+	_get_profile()->set_deadzone_extent(p_extent);
+	_get_profile()->set_direction_span(p_span);
+}
 
@@ -2,6 +2,7 @@
 #define TOUCH_SCREEN_PAD
 
 #include "TouchControl.h"
+#include "../Bitwise/StreamGraph.h"
 
 class TouchScreenPad : public TouchControl {
 	GDCLASS(TouchScreenPad, TouchControl);
@@ -25,12 +26,12 @@ private:
 	Direction direction = DIR_NEUTRAL;
 	bool centered = true;
 	Point2 offset_center = Point2(0,0); //Doesn't affect texture
-	real_t deadzone_extent;
-	real_t cardinal_direction_span;
 
 	bool _propagate_on_unpause = false;
 	bool update_cache = false;
 
+	Ref<OutputPlug> direction_plug; // created once asked for
+
 protected:
 	virtual const bool _set_deadzone_extent(real_t p_extent);
 	virtual const bool _set_cardinal_direction_span(real_t p_span);
@@ -40,6 +41,7 @@ protected:
 
 	void _update_cache_dirty();
 	bool is_update_cache();
+	virtual void _profile_changed() override;
 
 	void _notification(int p_what);
 	static void _bind_methods();
@@ -61,6 +63,8 @@ public:
 	real_t get_cardinal_direction_span() const;
 
 	Direction get_direction() const;
+	virtual Vector2 get_vector() const; // length up to 1, a dpad is always fully pushed
+	Ref<OutputPlug> get_direction_plug();
 
 	TouchScreenPad(real_t p_extent, real_t p_span);
 };
@@ -2,5 +2,15 @@ def can_build(env, platform):
     return True
 
 
+def get_opts(platform):
+    from SCons.Variables import BoolVariable
+
+    return [
+        BoolVariable("marthvon_monitors", "Instrument Character2DSideScroller with performance monitors", False),
+        BoolVariable("marthvon_benchmark", "Build the CharacterBenchmark2D harness and count allocations", False),
+        BoolVariable("marthvon_tracing", "Record Chrome trace events in the touch and character pipelines", False),
+    ]
+
+
 def configure(env):
     pass
@@ -1,51 +1,132 @@
 #include "register_types.h"
 #include "core/object/class_db.h"
+#include "core/config/engine.h"
 
-//#include "Bitwise/BitwiseCharacter.h"
-//#include "Bitwise/BaseStream.h"
+#include "Bitwise/BitwiseCharacter.h"
+#include "Bitwise/BaseStream.h"
+#include "Bitwise/StreamGraph.h"
+#include "Bitwise/GhostRecording.h"
 
 //#include "Character/Character.h"
-//#include "Character/Controller.h"
-//#include "Character/InteractionServer.h"
+#include "Character/Controller.h"
+#include "Character/InteractionServer.h"
 //#include "Character/RealCharacter3D.h"
+#include "Character/GroundedMovementData1D.h"
+#include "Character/MovementData2D.h"
+#include "Character/MovementSet.h"
+#include "Character/Character2DSideScroller.h"
+#include "Character/JumpReachabilityGraph2D.h"
+#include "Character/GhostPlayer2D.h"
+#include "Character/TileOccupancyGrid2D.h"
+#include "Character/CharacterPool2D.h"
+#include "Character/CharacterBenchmark2D.h"
 
+#include "TouchScreenUI/TouchControlProfile.h"
 #include "TouchScreenUI/TouchControl.h"
 #include "TouchScreenUI/TouchScreenPad.h"
 #include "TouchScreenUI/TouchScreenDPad.h"
 #include "TouchScreenUI/TouchScreenJoystick.h"
 #include "TouchScreenUI/TouchButton.h"
+#include "TouchScreenUI/TouchInputQueue.h"
+
+#include "Profiling/Tracer.h"
+
+static InteractionServer2D* interaction_server = nullptr;
+static TouchInputQueue* touch_input_queue = nullptr;
+static Ref<ResourceFormatLoaderMovementSet> movement_set_loader;
+static Ref<ResourceFormatSaverMovementSet> movement_set_saver;
+#ifdef MARTHVON_TRACING
+static Tracer* tracer = nullptr;
+#endif
 
 void initialize_authorMarthvon_module(ModuleInitializationLevel p_level) {
 	if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
 		return;
 	}
+#ifdef MARTHVON_TRACING
+	GDREGISTER_CLASS(Tracer);
+	tracer = memnew(Tracer);
+	Engine::get_singleton()->add_singleton(Engine::Singleton("Tracer", Tracer::get_singleton()));
+	tracer->parse_command_line();
+#endif
+
 	//BaseStreamSignalStringNames::create();
 	//
-	//GDREGISTER_CLASS(BaseStream);
-	//GDREGISTER_CLASS(InputPlug);
-	//GDREGISTER_CLASS(OutputPlug);
+	GDREGISTER_CLASS(BaseStream);
+	GDREGISTER_CLASS(InputPlug);
+	GDREGISTER_CLASS(OutputPlug);
+	GDREGISTER_CLASS(StreamGraph);
 	//
 	//GDREGISTER_CLASS(Character3D);
 	//GDREGISTER_CLASS(Player3D);
 	//GDREGISTER_CLASS(RealCharacter3D);
-	//GDREGISTER_CLASS(BitwiseCharacter);
+	GDREGISTER_CLASS(BitwiseCharacter);
+	GDREGISTER_CLASS(GhostRecording);
 
 	//Player3DController::Player3DStringNames::create();
-	//GDREGISTER_CLASS(Controller);
 	//GDREGISTER_CLASS(Player3DController);
 
-	//GDREGISTER_CLASS(InteractionServer);
-	//GDREGISTER_CLASS(Interactables);
+	GDREGISTER_CLASS(InteractionServer2D);
+	GDREGISTER_CLASS(Interactable2D);
+	interaction_server = memnew(InteractionServer2D);
+	Engine::get_singleton()->add_singleton(Engine::Singleton("InteractionServer2D", InteractionServer2D::get_singleton()));
+
+	GDREGISTER_CLASS(GroundedMovementData1D);
+	GDREGISTER_CLASS(MovementData2D);
+	GDREGISTER_CLASS(MovementSet);
+	movement_set_loader.instantiate();
+	ResourceLoader::add_resource_format_loader(movement_set_loader);
+	movement_set_saver.instantiate();
+	ResourceSaver::add_resource_format_saver(movement_set_saver);
+	GDREGISTER_CLASS(Character2DSideScroller);
+	GDREGISTER_CLASS(JumpReachabilityGraph2D);
+	GDREGISTER_CLASS(GhostPlayer2D);
+	GDREGISTER_CLASS(TileOccupancyGrid2D);
+	GDREGISTER_CLASS(CharacterPool2D);
+	GDREGISTER_CLASS(ControllerMapping2D);
+	GDREGISTER_CLASS(Controller2D);
+#ifdef MARTHVON_BENCHMARK
+	GDREGISTER_CLASS(CharacterBenchmark2D);
+#endif
 
+	GDREGISTER_CLASS(TouchControlProfile);
 	GDREGISTER_ABSTRACT_CLASS(TouchControl);
 	GDREGISTER_ABSTRACT_CLASS(TouchScreenPad);
 	GDREGISTER_CLASS(TouchScreenDPad);
 	GDREGISTER_CLASS(TouchScreenJoystick);
 	GDREGISTER_CLASS(TouchButton);
+	GDREGISTER_CLASS(TouchInputQueue);
+	touch_input_queue = memnew(TouchInputQueue);
+	Engine::get_singleton()->add_singleton(Engine::Singleton("TouchInputQueue", TouchInputQueue::get_singleton()));
 }
 
 void uninitialize_authorMarthvon_module(ModuleInitializationLevel p_level) {
 	if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
 		return;
 	}
+#ifdef MARTHVON_MONITORS
+	Character2DSideScroller::remove_performance_monitors();
+#endif
+	ResourceLoader::remove_resource_format_loader(movement_set_loader);
+	movement_set_loader.unref();
+	ResourceSaver::remove_resource_format_saver(movement_set_saver);
+	movement_set_saver.unref();
+	if (interaction_server) {
+		Engine::get_singleton()->remove_singleton("InteractionServer2D");
+		memdelete(interaction_server);
+		interaction_server = nullptr;
+	}
+	if (touch_input_queue) {
+		Engine::get_singleton()->remove_singleton("TouchInputQueue");
+		memdelete(touch_input_queue);
+		touch_input_queue = nullptr;
+	}
+#ifdef MARTHVON_TRACING
+	if (tracer) {
+		tracer->dump_on_exit();
+		Engine::get_singleton()->remove_singleton("Tracer");
+		memdelete(tracer);
+		tracer = nullptr;
+	}
+#endif
 }
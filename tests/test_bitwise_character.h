@@ -0,0 +1,122 @@
+#ifndef TEST_BITWISE_CHARACTER_H
+#define TEST_BITWISE_CHARACTER_H
+
+#include "tests/test_macros.h"
+
+#include "../Bitwise/BitwiseCharacter.h"
+
+namespace TestBitwiseCharacter {
+
+static Vector2 quantize(const Vector2 p_value, const real_t p_precision) {
+	return Vector2(Math::round(p_value.x / p_precision), Math::round(p_value.y / p_precision)) * p_precision;
+}
+
+// writes one tick into its own stream and reads it back, returns the bits it took
+static int loopback(BitwiseCharacter* p_writer, BitwiseCharacter* p_reader, Character2DSideScroller* p_from, Character2DSideScroller* p_to, const Ref<BaseStream>& p_stream, const int64_t p_tick, bool* r_delta = nullptr) {
+	p_stream->clear();
+	p_writer->write(p_from, p_stream, p_tick);
+	if (r_delta) {
+		*r_delta = p_stream->read_bool();
+		p_stream->reset_read();
+	}
+	CHECK(p_reader->read(p_stream, p_to, p_tick));
+	CHECK_FALSE(p_stream->is_read_overflow());
+	return p_stream->get_bit_size();
+}
+
+TEST_CASE("[Modules][BitwiseCharacter] Loopback with acknowledgements") {
+	Ref<BitwiseCharacter> writer = memnew(BitwiseCharacter);
+	Ref<BitwiseCharacter> reader = memnew(BitwiseCharacter);
+	Ref<BaseStream> stream = memnew(BaseStream);
+	Character2DSideScroller* from = memnew(Character2DSideScroller);
+	Character2DSideScroller* to = memnew(Character2DSideScroller);
+
+	const int ticks = 100;
+	for (int64_t tick = 0; tick < ticks; ++tick) {
+		const Vector2 position = Vector2(10.03 + tick * 3.7, -4.41 - tick * 0.9);
+		const Vector2 velocity = Vector2(222.13, tick * 9.81);
+		from->set_global_position(position);
+		from->set_velocity(velocity);
+		from->set_state(tick < ticks / 2 ? (unsigned short)Character2DSideScroller::State::STATE_RUNNING : (unsigned short)Character2DSideScroller::State::STATE_FALLING);
+		from->toggle_facing_right(tick & 1);
+
+		loopback(writer.ptr(), reader.ptr(), from, to, stream, tick);
+		CHECK(to->get_global_position().is_equal_approx(quantize(position, writer->get_position_precision())));
+		CHECK(to->get_velocity().is_equal_approx(quantize(velocity, writer->get_velocity_precision())));
+		CHECK(to->get_state() == from->get_state());
+		CHECK(to->is_facing_right() == from->is_facing_right());
+		if (tick >= 2)
+			writer->acknowledge(tick - 2); // two ticks of latency
+	}
+	CHECK(writer->get_baseline_tick() == ticks - 3);
+
+	// nothing changed since the baseline, only the header is sent
+	from->set_global_position(Vector2(64, 32));
+	from->set_velocity(Vector2());
+	loopback(writer.ptr(), reader.ptr(), from, to, stream, ticks);
+	writer->acknowledge(ticks);
+	CHECK_MESSAGE(loopback(writer.ptr(), reader.ptr(), from, to, stream, ticks + 1) == 1 + 8 + 4, "An unchanged tick is the baseline bit, the tick distance and the field mask.");
+	CHECK(stream->get_byte_size() == 2);
+
+	memdelete(from);
+	memdelete(to);
+}
+
+TEST_CASE("[Modules][BitwiseCharacter] Baseline evicted by history wraparound") {
+	Ref<BitwiseCharacter> writer = memnew(BitwiseCharacter);
+	Ref<BitwiseCharacter> reader = memnew(BitwiseCharacter);
+	writer->set_history_size(4);
+	reader->set_history_size(4);
+	Ref<BaseStream> stream = memnew(BaseStream);
+	Character2DSideScroller* from = memnew(Character2DSideScroller);
+	Character2DSideScroller* to = memnew(Character2DSideScroller);
+
+	bool delta = true;
+	from->set_global_position(Vector2(1, 2));
+	loopback(writer.ptr(), reader.ptr(), from, to, stream, 0, &delta);
+	CHECK_FALSE(delta);
+	loopback(writer.ptr(), reader.ptr(), from, to, stream, 1, &delta);
+	writer->acknowledge(1);
+	for (int64_t tick = 2; tick <= 4; ++tick) {
+		from->set_global_position(Vector2(1 + tick, 2));
+		loopback(writer.ptr(), reader.ptr(), from, to, stream, tick, &delta);
+		CHECK(delta);
+	}
+	// tick 5 still encodes against tick 1 while taking its slot
+	from->set_global_position(Vector2(6, 2));
+	loopback(writer.ptr(), reader.ptr(), from, to, stream, 5, &delta);
+	CHECK(delta);
+	CHECK(to->get_global_position().is_equal_approx(Vector2(6, 2)));
+	// the baseline is gone, the next tick is sent whole
+	from->set_global_position(Vector2(7, 2));
+	loopback(writer.ptr(), reader.ptr(), from, to, stream, 6, &delta);
+	CHECK_FALSE(delta);
+	CHECK(to->get_global_position().is_equal_approx(Vector2(7, 2)));
+
+	memdelete(from);
+	memdelete(to);
+}
+
+TEST_CASE("[Modules][BitwiseCharacter] Custom state using all 16 bits") {
+	Ref<BitwiseCharacter> writer = memnew(BitwiseCharacter);
+	Ref<BitwiseCharacter> reader = memnew(BitwiseCharacter);
+	Ref<BaseStream> stream = memnew(BaseStream);
+	Character2DSideScroller* from = memnew(Character2DSideScroller);
+	Character2DSideScroller* to = memnew(Character2DSideScroller);
+
+	const unsigned short state = (1 << 15) | (1 << 10) | (unsigned short)Character2DSideScroller::State::STATE_RUNNING;
+	from->set_global_position(Vector2());
+	from->set_velocity(Vector2());
+	from->set_state(state);
+	from->toggle_facing_right(true);
+	// baseline bit, field mask, the state width and the state
+	CHECK(loopback(writer.ptr(), reader.ptr(), from, to, stream, 0) == 1 + 4 + 5 + 16);
+	CHECK(to->get_state() == state);
+
+	memdelete(from);
+	memdelete(to);
+}
+
+} // namespace TestBitwiseCharacter
+
+#endif // TEST_BITWISE_CHARACTER_H
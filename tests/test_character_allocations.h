@@ -0,0 +1,77 @@
+#ifndef TEST_CHARACTER_ALLOCATIONS_H
+#define TEST_CHARACTER_ALLOCATIONS_H
+
+#ifdef MARTHVON_BENCHMARK
+
+#include "tests/test_macros.h"
+
+#include "scene/main/window.h"
+#include "../Character/CharacterBenchmark2D.h"
+#include "../Profiling/AllocationCounter.h"
+
+namespace TestCharacterAllocations {
+
+#ifdef MARTHVON_ALLOCATION_HOOK
+
+TEST_CASE("[Modules][AllocationCounter] Counts engine allocations of the main thread") {
+	const int64_t begin = AllocationCounter::get_count();
+	Vector<int> values;
+	values.resize(64);
+	Object* object = memnew(Object);
+	memdelete(object);
+	CHECK(AllocationCounter::get_count() - begin >= 2);
+}
+
+// the warmup takes allocation_warmup_ticks, everything after it is steady
+static Dictionary run_benchmark(const CharacterBenchmark2D::InputPattern p_pattern, const bool p_kinematic) {
+	CharacterBenchmark2D* benchmark = memnew(CharacterBenchmark2D);
+	benchmark->toggle_autostart(false);
+	benchmark->toggle_quit_on_finish(false);
+	benchmark->toggle_check_allocations(true);
+	benchmark->toggle_kinematic_characters(p_kinematic);
+	benchmark->set_input_pattern(p_pattern);
+	benchmark->set_character_count(32);
+	benchmark->set_tick_count(300);
+	SceneTree::get_singleton()->get_root()->add_child(benchmark);
+	benchmark->start();
+	for (int i = 0; i < 400 && benchmark->is_running(); ++i)
+		SceneTree::get_singleton()->physics_process(1.0 / 60.0);
+	CHECK_FALSE(benchmark->is_running());
+	const Dictionary report = benchmark->get_report();
+	memdelete(benchmark);
+	return report;
+}
+
+static void check_steady(const Dictionary& p_report) {
+	REQUIRE(p_report.has("allocation_check_passed"));
+	CHECK_MESSAGE(double(p_report["steady_allocations_per_tick"]) == 0.0, "Steady character ticks don't allocate.");
+	CHECK_MESSAGE(double(p_report["steady_allocations_per_touch_event"]) == 0.0, "Steady touch events don't allocate.");
+	CHECK(bool(p_report["allocation_check_passed"]));
+}
+
+TEST_CASE("[SceneTree][Modules][CharacterBenchmark2D] Steady ticks and touch events don't allocate") {
+	SUBCASE("Mixed patterns on bodies") {
+		check_steady(run_benchmark(CharacterBenchmark2D::PATTERN_MIXED, false));
+	}
+	SUBCASE("Multi jumps") {
+		check_steady(run_benchmark(CharacterBenchmark2D::PATTERN_MULTI_JUMP, false));
+	}
+	SUBCASE("Custom states on the kinematic grid") {
+		check_steady(run_benchmark(CharacterBenchmark2D::PATTERN_CUSTOM, true));
+	}
+}
+
+#else
+
+// counting needs the link time wrap of the Memory allocator, only set up on linuxbsd
+TEST_CASE("[Modules][AllocationCounter] Allocation checks" * doctest::skip()) {
+	MESSAGE("Allocations can't be counted on this platform, the allocation checks are skipped.");
+}
+
+#endif
+
+} // namespace TestCharacterAllocations
+
+#endif
+
+#endif // TEST_CHARACTER_ALLOCATIONS_H
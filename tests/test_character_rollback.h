@@ -0,0 +1,131 @@
+#ifndef TEST_CHARACTER_ROLLBACK_H
+#define TEST_CHARACTER_ROLLBACK_H
+
+#include "tests/test_macros.h"
+
+#include "scene/2d/collision_shape_2d.h"
+#include "scene/main/window.h"
+#include "scene/resources/rectangle_shape_2d.h"
+#include "../Character/Character2DSideScroller.h"
+#ifdef MODULE_GDSCRIPT_ENABLED
+#include "modules/gdscript/gdscript.h"
+#endif
+
+namespace TestCharacterRollback {
+
+static const int ticks = 90;
+static const int rollback_tick = 20;
+
+// a kinematic character standing on the floor of its own grid, moved by its tick
+static Character2DSideScroller* create_character() {
+	Ref<GroundedMovementData1D> grounded;
+	grounded.instantiate();
+	grounded->set_speed(160);
+	grounded->set_acceleration(480);
+	grounded->set_max_speed(320);
+	grounded->set_min_speed(-320);
+	Ref<MovementData2D> jumping;
+	jumping.instantiate();
+	jumping->set_speed(160);
+	jumping->set_max_speed(320);
+	jumping->set_min_speed(-320);
+	jumping->set_jump_height(96);
+	jumping->set_jump_duration(0.4);
+	Array grounded_list;
+	grounded_list.resize(2);
+	grounded_list.fill(grounded);
+	Array jumping_list;
+	jumping_list.resize(3);
+	jumping_list.fill(jumping);
+	Ref<MovementSet> movement_set;
+	movement_set.instantiate();
+	movement_set->build(grounded_list, jumping_list);
+
+	Ref<TileOccupancyGrid2D> grid;
+	grid.instantiate();
+	grid->setup(Vector2(0, -256), Vector2(16, 16), Rect2i(0, 0, 256, 20));
+	grid->fill_rect(Rect2(0, 0, 4096, 64), true);
+
+	Character2DSideScroller* character = memnew(Character2DSideScroller);
+	character->set_movement_set(movement_set);
+	character->set_max_jump_count(2);
+	character->set_rollback_capacity(128);
+	character->toggle_auto_move(true);
+	character->set_position(Vector2(64, -16));
+	Ref<RectangleShape2D> shape;
+	shape.instantiate();
+	shape->set_size(Vector2(16, 32));
+	CollisionShape2D* collision = memnew(CollisionShape2D);
+	collision->set_shape(shape);
+	character->add_child(collision);
+	character->set_kinematic_grid(grid);
+	return character;
+}
+
+// runs on, jumps twice and runs again, -1 keeps whatever the state machine made of the last input
+static PackedInt32Array create_inputs() {
+	PackedInt32Array inputs;
+	inputs.resize(ticks);
+	inputs.fill(-1);
+	inputs.set(0, (int)Character2DSideScroller::State::STATE_RUNNING);
+	inputs.set(10, (int)Character2DSideScroller::State::STATE_RUNNING | (int)Character2DSideScroller::State::STATE_FALLING);
+	inputs.set(50, (int)Character2DSideScroller::State::STATE_RUNNING | (int)Character2DSideScroller::State::STATE_FALLING);
+	inputs.set(75, (int)Character2DSideScroller::State::STATE_RUNNING);
+	return inputs;
+}
+
+// the straight-line run, every tick saved
+static void run_live(Character2DSideScroller* p_character, const PackedInt32Array& p_inputs) {
+	p_character->save_state(0);
+	for (int i = 0; i < p_inputs.size(); ++i) {
+		if (p_inputs[i] >= 0)
+			p_character->set_state(p_inputs[i]);
+		SceneTree::get_singleton()->physics_process(1.0 / 60.0);
+		p_character->save_state(i + 1);
+	}
+}
+
+static void check_resimulation(Character2DSideScroller* p_character) {
+	SceneTree::get_singleton()->get_root()->add_child(p_character);
+	const Vector2 start = p_character->get_global_position();
+	const PackedInt32Array inputs = create_inputs();
+	run_live(p_character, inputs);
+	const Vector2 position = p_character->get_global_position();
+	const Vector2 velocity = p_character->get_velocity();
+	const int state = p_character->get_state();
+	CHECK_MESSAGE(position != start, "The character moved, the comparison below isn't trivial.");
+
+	REQUIRE(p_character->restore_state(rollback_tick));
+	CHECK(p_character->get_global_position() != position);
+	REQUIRE(p_character->resimulate(rollback_tick, inputs.slice(rollback_tick)));
+	CHECK(p_character->get_global_position() == position);
+	CHECK(p_character->get_velocity() == velocity);
+	CHECK(p_character->get_state() == state);
+	memdelete(p_character);
+}
+
+TEST_CASE("[SceneTree][Modules][Character2DSideScroller] Resimulation matches the straight-line run") {
+	check_resimulation(create_character());
+}
+
+#ifdef MODULE_GDSCRIPT_ENABLED
+TEST_CASE("[SceneTree][Modules][Character2DSideScroller] Resimulation replays script transitions") {
+	Ref<GDScript> script;
+	script.instantiate();
+	script->set_source_code(
+			"extends Character2DSideScroller\n"
+			"var jumps = 0\n"
+			"func _transition_1to1(delta):\n"
+			"\tjumps += 1\n"
+			"\tvelocity.x += 7.0\n"
+			"\treturn true\n");
+	REQUIRE(script->reload() == OK);
+	Character2DSideScroller* character = create_character();
+	character->set_script(script);
+	check_resimulation(character);
+}
+#endif
+
+} // namespace TestCharacterRollback
+
+#endif // TEST_CHARACTER_ROLLBACK_H
@@ -0,0 +1,62 @@
+#ifndef TEST_CONTROLLER_2D_H
+#define TEST_CONTROLLER_2D_H
+
+#include "tests/test_macros.h"
+
+#include "scene/main/window.h"
+#include "../Character/Controller.h"
+
+namespace TestController2D {
+
+TEST_CASE("[SceneTree][Modules][Controller2D] A tap shorter than a tick reaches the character") {
+	Window* root = SceneTree::get_singleton()->get_root();
+	TouchButton* button = memnew(TouchButton);
+	button->set_position(Vector2(0, 0));
+	button->set_size(Vector2(100, 100));
+	root->add_child(button);
+	button->set_process_input(true); // the button only turns its input on when its visibility changes
+	// without movement the character keeps whatever state is written to it
+	Character2DSideScroller* character = memnew(Character2DSideScroller);
+	character->toggle_movement_disable(true);
+	root->add_child(character);
+
+	const int tap_state = 1 << 10;
+	Ref<ControllerMapping2D> mapping;
+	mapping.instantiate();
+	PackedInt32Array press_states;
+	press_states.push_back(tap_state);
+	mapping->set_button_press_states(press_states);
+	Controller2D* controller = memnew(Controller2D);
+	controller->set_character_path(character->get_path());
+	Array button_paths;
+	button_paths.push_back(button->get_path());
+	controller->set_button_paths(button_paths);
+	controller->set_mapping(mapping);
+	root->add_child(controller);
+
+	SceneTree::get_singleton()->physics_process(1.0 / 60.0);
+	REQUIRE(character->get_state() != tap_state);
+
+	// pressed and released before the next tick runs
+	Ref<InputEventScreenTouch> touch;
+	touch.instantiate();
+	touch->set_index(0);
+	touch->set_position(Vector2(50, 50));
+	touch->set_pressed(true);
+	root->push_input(touch);
+	CHECK(button->get_finger_index() == 0);
+	touch->set_pressed(false);
+	root->push_input(touch);
+	CHECK(button->get_finger_index() == -1);
+
+	SceneTree::get_singleton()->physics_process(1.0 / 60.0);
+	CHECK_MESSAGE(character->get_state() == tap_state, "The press state of the tapped button was written.");
+
+	memdelete(controller);
+	memdelete(character);
+	memdelete(button);
+}
+
+} // namespace TestController2D
+
+#endif // TEST_CONTROLLER_2D_H
@@ -0,0 +1,101 @@
+#ifndef TEST_MOVEMENT_SET_H
+#define TEST_MOVEMENT_SET_H
+
+#include "tests/test_macros.h"
+
+#include "../Character/MovementSet.h"
+
+namespace TestMovementSet {
+
+static Ref<MovementSet> create_set() {
+	Array grounded;
+	for (int i = 0; i < 2; ++i) {
+		Ref<GroundedMovementData1D> data;
+		data.instantiate();
+		data->set_speed(100 + i);
+		data->set_acceleration(400.5 + i);
+		data->set_max_speed(300 + i);
+		data->set_min_speed(-300 - i);
+		data->set_scale_inherited_speed(0.25);
+		grounded.push_back(data);
+	}
+	Array jumping;
+	for (int i = 0; i < 3; ++i) {
+		Ref<MovementData2D> data;
+		data.instantiate();
+		data->set_speed(160 + i);
+		data->set_max_speed(320);
+		data->set_min_speed(-320);
+		data->set_jump_height(96 + 8 * i);
+		data->set_jump_duration(0.5);
+		data->set_xVel2yVel_ratio(0.125 * i);
+		jumping.push_back(data);
+	}
+	Ref<MovementSet> set;
+	set.instantiate();
+	set->build(grounded, jumping);
+	return set;
+}
+
+static void check_profiles_equal(const Ref<MovementSet>& p_a, const Ref<MovementSet>& p_b) {
+	REQUIRE(p_a->get_grounded_count() == p_b->get_grounded_count());
+	REQUIRE(p_a->get_jumping_count() == p_b->get_jumping_count());
+	for (int i = 0; i < p_a->get_grounded_count() + p_a->get_jumping_count(); ++i) {
+		const MovementSet::Profile a = p_a->get_profile(i);
+		const MovementSet::Profile b = p_b->get_profile(i);
+		CHECK(a.speed == b.speed);
+		CHECK(a.acceleration == b.acceleration);
+		CHECK(a.max_speed == b.max_speed);
+		CHECK(a.min_speed == b.min_speed);
+		CHECK(a.scale_inherited_speed == b.scale_inherited_speed);
+		CHECK(a.jump_height == b.jump_height);
+		CHECK(a.jump_duration == b.jump_duration);
+		CHECK(a.xVel_to_yVel_ratio == b.xVel_to_yVel_ratio);
+		CHECK(a.scale_inherited_ySpeed == b.scale_inherited_ySpeed);
+	}
+}
+
+TEST_CASE("[Modules][MovementSet] Data round trip") {
+	Ref<MovementSet> set = create_set();
+	const PackedByteArray data = set->get_data();
+	CHECK(data.size() == (int)(MovementSet::HEADER_SIZE + 5 * MovementSet::PROFILE_FIELDS * 4));
+
+	Ref<MovementSet> loaded;
+	loaded.instantiate();
+	REQUIRE(loaded->set_data(data) == OK);
+	check_profiles_equal(set, loaded);
+	CHECK(loaded->get_data() == data);
+	CHECK(loaded->get_grounded()[1]->get_acceleration() == doctest::Approx(401.5));
+	CHECK(loaded->get_jumping()[2]->get_jump_height() == doctest::Approx(112));
+}
+
+TEST_CASE("[Modules][MovementSet] Edits of the shared movement data are saved") {
+	Ref<MovementSet> set = create_set();
+	set->get_grounded()[0]->set_speed(42);
+	set->get_jumping()[1]->set_jump_duration(0.75);
+	CHECK(set->get_profile(0).speed == 42);
+
+	Ref<MovementSet> loaded;
+	loaded.instantiate();
+	REQUIRE(loaded->set_data(set->get_data()) == OK);
+	CHECK(loaded->get_grounded()[0]->get_speed() == 42);
+	CHECK(loaded->get_jumping()[1]->get_jump_duration() == doctest::Approx(0.75));
+	check_profiles_equal(set, loaded);
+}
+
+TEST_CASE("[Modules][MovementSet] Corrupt data is rejected") {
+	Ref<MovementSet> set = create_set();
+	PackedByteArray data = set->get_data();
+	Ref<MovementSet> loaded;
+	loaded.instantiate();
+	ERR_PRINT_OFF;
+	CHECK(loaded->set_data(data.slice(0, data.size() - 4)) == ERR_FILE_CORRUPT);
+	data.set(0, 0);
+	CHECK(loaded->set_data(data) == ERR_FILE_UNRECOGNIZED);
+	ERR_PRINT_ON;
+	CHECK(loaded->get_grounded_count() == 0);
+}
+
+} // namespace TestMovementSet
+
+#endif // TEST_MOVEMENT_SET_H
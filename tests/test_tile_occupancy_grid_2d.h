@@ -0,0 +1,50 @@
+#ifndef TEST_TILE_OCCUPANCY_GRID_2D_H
+#define TEST_TILE_OCCUPANCY_GRID_2D_H
+
+#include "tests/test_macros.h"
+
+#include "../Character/TileOccupancyGrid2D.h"
+
+namespace TestTileOccupancyGrid2D {
+
+// 16 pixel cells, solid at (1, 2) and (5, 2), so row 2 spans y 32 to 48 with walls at x 16..32 and 80..96
+static Ref<TileOccupancyGrid2D> create_grid() {
+	Ref<TileOccupancyGrid2D> grid;
+	grid.instantiate();
+	grid->setup(Vector2(), Vector2(16, 16), Rect2i(0, 0, 10, 10));
+	grid->set_cell_solid(Vector2i(1, 2), true);
+	grid->set_cell_solid(Vector2i(5, 2), true);
+	return grid;
+}
+
+TEST_CASE("[Modules][TileOccupancyGrid2D] Sweeps stop at the first solid cell") {
+	Ref<TileOccupancyGrid2D> grid = create_grid();
+	CHECK(grid->sweep(Rect2(40, 32, 16, 16), Vector2::AXIS_X, 100) == doctest::Approx(80 - 56));
+	CHECK(grid->sweep(Rect2(40, 32, 16, 16), Vector2::AXIS_X, -100) == doctest::Approx(32 - 40));
+	CHECK_MESSAGE(grid->sweep(Rect2(40, 32, 16, 16), Vector2::AXIS_X, 10) == doctest::Approx(10), "Motion short of the wall is kept.");
+	CHECK(grid->sweep(Rect2(80, 0, 16, 16), Vector2::AXIS_Y, 100) == doctest::Approx(32 - 16));
+	CHECK(grid->sweep(Rect2(80, 100, 16, 16), Vector2::AXIS_Y, -100) == doctest::Approx(48 - 100));
+}
+
+TEST_CASE("[Modules][TileOccupancyGrid2D] A box resting on an edge") {
+	Ref<TileOccupancyGrid2D> grid = create_grid();
+	CHECK(grid->sweep(Rect2(64, 32, 16, 16), Vector2::AXIS_X, 10) == doctest::Approx(0));
+	CHECK(grid->sweep(Rect2(32, 32, 16, 16), Vector2::AXIS_X, -10) == doctest::Approx(0));
+	CHECK_MESSAGE(grid->sweep(Rect2(64, 32, 16, 16), Vector2::AXIS_X, -10) == doctest::Approx(-10), "Moving away from the wall is free.");
+	// standing on top of the wall, the cell below only touches the box
+	CHECK(grid->sweep(Rect2(70, 16, 16, 16), Vector2::AXIS_X, 20) == doctest::Approx(20));
+	CHECK(grid->sweep(Rect2(80, 16, 16, 16), Vector2::AXIS_Y, 10) == doctest::Approx(0));
+}
+
+TEST_CASE("[Modules][TileOccupancyGrid2D] A box starting inside a solid cell can leave it") {
+	Ref<TileOccupancyGrid2D> grid = create_grid();
+	const Rect2 stuck = Rect2(85, 36, 8, 8);
+	CHECK(grid->sweep(stuck, Vector2::AXIS_X, 20) == doctest::Approx(20));
+	CHECK(grid->sweep(stuck, Vector2::AXIS_X, -100) == doctest::Approx(32 - 85));
+	CHECK(grid->sweep(stuck, Vector2::AXIS_Y, 20) == doctest::Approx(20));
+	CHECK(grid->sweep(stuck, Vector2::AXIS_Y, -20) == doctest::Approx(-20));
+}
+
+} // namespace TestTileOccupancyGrid2D
+
+#endif // TEST_TILE_OCCUPANCY_GRID_2D_H
@@ -0,0 +1,113 @@
+#ifndef TEST_TOUCH_HEATMAP_H
+#define TEST_TOUCH_HEATMAP_H
+
+#include "tests/test_macros.h"
+
+#include "scene/main/window.h"
+#include "../TouchScreenUI/TouchButton.h"
+#include "../TouchScreenUI/TouchHeatmap.h"
+
+namespace TestTouchHeatmap {
+
+TEST_CASE("[Modules][TouchHeatmap] Points are quantized to cells") {
+	TouchHeatmap heatmap;
+	heatmap.setup(4, 4);
+	heatmap.add(TouchHeatmap::LAYER_PRESSES, Vector2(0.3, 0.6));
+	heatmap.add(TouchHeatmap::LAYER_PRESSES, Vector2(0.49, 0.74));
+	heatmap.add(TouchHeatmap::LAYER_MISSES, Vector2(0, 0));
+	CHECK(heatmap.get_cell(TouchHeatmap::LAYER_PRESSES, Vector2i(1, 2)) == 2);
+	CHECK(heatmap.get_cell(TouchHeatmap::LAYER_MISSES, Vector2i(0, 0)) == 1);
+	CHECK_MESSAGE(heatmap.get_cell(TouchHeatmap::LAYER_PRESSES, Vector2i(0, 0)) == 0, "Layers don't share cells.");
+	const PackedInt32Array presses = heatmap.get_layer(TouchHeatmap::LAYER_PRESSES);
+	REQUIRE(presses.size() == 16);
+	CHECK(presses[2 * 4 + 1] == 2);
+}
+
+TEST_CASE("[Modules][TouchHeatmap] Points outside of the area are dropped") {
+	TouchHeatmap heatmap;
+	heatmap.setup(4, 4);
+	heatmap.add(TouchHeatmap::LAYER_PRESSES, Vector2(1, 0.5));
+	heatmap.add(TouchHeatmap::LAYER_PRESSES, Vector2(0.5, 1));
+	heatmap.add(TouchHeatmap::LAYER_PRESSES, Vector2(-0.01, 0.5));
+	heatmap.add(TouchHeatmap::LAYER_PRESSES, Vector2(0.5, NAN));
+	heatmap.add(TouchHeatmap::LAYER_PRESSES, Vector2(0.9999, 0.9999));
+	const PackedInt32Array presses = heatmap.get_layer(TouchHeatmap::LAYER_PRESSES);
+	int total = 0;
+	for (int i = 0; i < presses.size(); ++i)
+		total += presses[i];
+	CHECK(total == 1);
+	CHECK(heatmap.get_cell(TouchHeatmap::LAYER_PRESSES, Vector2i(3, 3)) == 1);
+
+	TouchHeatmap empty; // never set up, adding is a no-op
+	empty.add(TouchHeatmap::LAYER_PRESSES, Vector2(0.5, 0.5));
+	CHECK(empty.get_layer(TouchHeatmap::LAYER_PRESSES).is_empty());
+}
+
+TEST_CASE("[Modules][TouchHeatmap] Counts saturate") {
+	TouchHeatmap heatmap;
+	heatmap.setup(2, 2);
+	heatmap.set_cell(TouchHeatmap::LAYER_DRAGS, Vector2i(1, 1), UINT32_MAX - 1);
+	heatmap.add(TouchHeatmap::LAYER_DRAGS, Vector2(0.75, 0.75));
+	heatmap.add(TouchHeatmap::LAYER_DRAGS, Vector2(0.75, 0.75));
+	CHECK(heatmap.get_cell(TouchHeatmap::LAYER_DRAGS, Vector2i(1, 1)) == UINT32_MAX);
+	CHECK_MESSAGE(heatmap.get_layer(TouchHeatmap::LAYER_DRAGS)[3] == INT32_MAX, "Scripts get the count clamped to an int.");
+}
+
+static TouchButton* add_button(const Rect2 p_rect) {
+	TouchButton* button = memnew(TouchButton);
+	button->set_position(p_rect.position);
+	button->set_size(p_rect.size);
+	button->toggle_analytics(true);
+	SceneTree::get_singleton()->get_root()->add_child(button);
+	button->set_process_input(true); // the button only turns its input on when its visibility changes
+	return button;
+}
+
+static void tap(const Point2 p_position) {
+	Ref<InputEventScreenTouch> touch;
+	touch.instantiate();
+	touch->set_index(0);
+	touch->set_position(p_position);
+	touch->set_pressed(true);
+	SceneTree::get_singleton()->get_root()->push_input(touch);
+	touch->set_pressed(false);
+	SceneTree::get_singleton()->get_root()->push_input(touch);
+}
+
+static int sum(const PackedInt32Array& p_layer) {
+	int total = 0;
+	for (int i = 0; i < p_layer.size(); ++i)
+		total += p_layer[i];
+	return total;
+}
+
+// the margins reach a quarter of the size out, a is 0..100 with its margin to 125, b is 110..210 with its margin from 85
+TEST_CASE("[SceneTree][Modules][TouchControl] Screen misses are resolved once per touch") {
+	TouchButton* a = add_button(Rect2(0, 0, 100, 100));
+	TouchButton* b = add_button(Rect2(110, 0, 100, 100));
+	TouchControl::clear_screen_heatmap();
+
+	SUBCASE("A hit in the margin of another control is no miss") {
+		tap(Point2(95, 50));
+		CHECK(sum(TouchControl::get_screen_heatmap(TouchControl::HEATMAP_MISSES)) == 0);
+		CHECK(sum(a->get_heatmap(TouchControl::HEATMAP_PRESSES)) == 1);
+		CHECK_MESSAGE(sum(b->get_heatmap(TouchControl::HEATMAP_MISSES)) == 1, "B still sees the touch as a miss of its own.");
+	}
+	SUBCASE("A touch in the margins of two controls is one miss") {
+		tap(Point2(105, 50));
+		CHECK(sum(TouchControl::get_screen_heatmap(TouchControl::HEATMAP_MISSES)) == 1);
+	}
+	SUBCASE("Consecutive touches are resolved each on their own") {
+		tap(Point2(105, 50));
+		tap(Point2(95, 50));
+		tap(Point2(105, 60));
+		CHECK(sum(TouchControl::get_screen_heatmap(TouchControl::HEATMAP_MISSES)) == 2);
+	}
+
+	memdelete(a);
+	memdelete(b);
+}
+
+} // namespace TestTouchHeatmap
+
+#endif // TEST_TOUCH_HEATMAP_H